@@ -0,0 +1,284 @@
+/*
+[CyoArguments] benchmark.cpp
+
+The MIT License (MIT)
+
+Copyright (c) 2015-2016 Graham Bull
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Benchmarks for Linux and other POSIX platforms (build with ./build.sh)
+
+#include "cyoarguments.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace cyoarguments;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Allocations are counted, to measure the cost of registering options
+
+namespace
+{
+    std::size_t numAllocations = 0;
+    std::size_t allocatedBytes = 0;
+}
+
+// Every form of new and delete is replaced, so each is paired with malloc or free; the deletes
+// aren't inlined, since GCC would then see free called on memory from new (-Wmismatched-new-delete)
+
+void* operator new(std::size_t size)
+{
+    ++numAllocations;
+    allocatedBytes += size;
+    if (void* ptr = std::malloc((size != 0) ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+__attribute__((noinline)) void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    operator delete[](ptr);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    struct Settings
+    {
+        unsigned numFiles = 64;
+        ByteSize fileSize = ByteSize(4 << 20);
+        std::string dir = "benchmark_files";
+        std::chrono::milliseconds init = std::chrono::milliseconds(50);
+        unsigned runs = 3;
+        unsigned registrations = 1000;
+        std::string run = "all";
+    };
+
+    const char optionWords[][12] = {
+        "address", "buffer", "cache", "config", "debug", "directory", "encoding", "format",
+        "group", "host", "include", "jobs", "keyfile", "level", "limit", "mode",
+        "name", "output", "port", "prefix", "quiet", "retries", "size", "suffix",
+        "threads", "timeout", "user", "verbose", "version", "width", "workers", "zone"
+    };
+    const std::size_t numWords = sizeof(optionWords) / sizeof(optionWords[0]);
+
+    struct Registration
+    {
+        double microseconds;
+        std::size_t allocations;
+        std::size_t bytes;
+    };
+
+    // The global words are referred to, and the others copied
+    Name WordName(const char* word) { return Name::Literal(word); }
+    Name WordName(const std::string& word) { return word; }
+
+    // Registers an option for each word, with a literal description, repeatedly
+    template<typename W>
+    Registration Register(const W& words, unsigned registrations)
+    {
+        std::vector<int> targets(numWords);
+        const std::size_t allocations = numAllocations;
+        const std::size_t bytes = allocatedBytes;
+        const auto start = Clock::now();
+        for (unsigned registration = 0; registration < registrations; ++registration)
+        {
+            Arguments arguments;
+            for (std::size_t index = 0; index < numWords; ++index)
+                arguments.AddOption(WordName(words[index]), Text::Literal("description of the option"), targets[index]);
+        }
+        const auto elapsed = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        return { elapsed / registrations, (numAllocations - allocations) / registrations,
+            (allocatedBytes - bytes) / registrations };
+    }
+
+    void BenchmarkRegistration(const Settings& settings)
+    {
+        std::vector<std::string> dynamicWords(std::begin(optionWords), std::end(optionWords));
+        const Registration literal = Register(optionWords, settings.registrations);
+        const Registration dynamic = Register(dynamicWords, settings.registrations);
+
+        std::cout << "Registration: " << numWords << " options, " << sizeof(detail::Option<int>)
+            << " bytes per option (sizeof)\n";
+        std::cout << "  literal words: " << literal.microseconds << "us, " << literal.allocations
+            << " allocations of " << literal.bytes << " bytes\n";
+        std::cout << "  dynamic words: " << dynamic.microseconds << "us, " << dynamic.allocations
+            << " allocations of " << dynamic.bytes << " bytes\n";
+    }
+
+    bool WriteFile(const std::string& path, std::uint64_t size)
+    {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            return false;
+        std::vector<char> buffer(1 << 16, 'x');
+        bool ok = true;
+        for (std::uint64_t written = 0; ok && written < size; written += buffer.size())
+            ok = (::write(fd, buffer.data(), buffer.size()) == (ssize_t)buffer.size());
+        ok = ok && (::fsync(fd) == 0);
+        ::close(fd);
+        return ok;
+    }
+
+    void EvictFile(const std::string& path)
+    {
+        // The pages are clean (the file was synced), so they can be dropped from the page cache
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            ::close(fd);
+        }
+    }
+
+    std::uint64_t ReadFile(const std::string& path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return 0;
+        std::vector<char> buffer(1 << 16);
+        std::uint64_t total = 0;
+        for (ssize_t len; (len = ::read(fd, buffer.data(), buffer.size())) > 0; )
+            total += (std::uint64_t)len;
+        ::close(fd);
+        return total;
+    }
+
+    // Parses the paths, waits to simulate initialization, then reads the files
+    template<typename P>
+    double RunReadAhead(const std::vector<std::string>& paths, const Settings& settings)
+    {
+        for (const auto& path : paths)
+            EvictFile(path);
+
+        std::vector<char*> argv{ (char*)"benchmark" };
+        for (const auto& path : paths)
+            argv.push_back((char*)path.c_str());
+
+        const auto start = Clock::now();
+
+        std::vector<P> inputs;
+        Arguments arguments;
+        arguments.AddList("inputs", "input files", inputs);
+        if (!arguments.Process((int)argv.size(), argv.data()))
+            return 0;
+
+        std::this_thread::sleep_for(settings.init);
+
+        std::uint64_t total = 0;
+        for (const auto& input : inputs)
+            total += ReadFile(input.get());
+
+        const auto elapsed = Milliseconds(Clock::now() - start).count();
+        if (total != paths.size() * settings.fileSize.get())
+            std::cerr << "Short read: " << total << " bytes\n";
+        return elapsed;
+    }
+
+    void BenchmarkReadAhead(const Settings& settings)
+    {
+        ::mkdir(settings.dir.c_str(), 0755);
+
+        std::vector<std::string> paths;
+        for (unsigned index = 0; index < settings.numFiles; ++index)
+        {
+            paths.push_back(settings.dir + "/file" + std::to_string(index));
+            if (!WriteFile(paths.back(), settings.fileSize.get()))
+            {
+                std::cerr << "Cannot write " << paths.back() << '\n';
+                return;
+            }
+        }
+
+        std::cout << "Read-ahead: " << settings.numFiles << " files of " << settings.fileSize.get()
+            << " bytes, " << settings.init.count() << "ms of initialization\n";
+        for (unsigned run = 1; run <= settings.runs; ++run)
+        {
+            const double without = RunReadAhead<Path<PathIsFile>>(paths, settings);
+            const double with = RunReadAhead<Path<PathIsFile | PathReadAhead>>(paths, settings);
+            std::cout << "  run " << run << ": " << without << "ms without, " << with << "ms with PathReadAhead\n";
+        }
+
+        for (const auto& path : paths)
+            ::unlink(path.c_str());
+        ::rmdir(settings.dir.c_str());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+    Settings settings;
+
+    Arguments arguments;
+    arguments.SetName("runbenchmark");
+    arguments.AddOption("files", "number of files to read", settings.numFiles);
+    arguments.AddOption("size", "size of each file", settings.fileSize);
+    arguments.AddOption("dir", "directory for the files (on a local disk)", settings.dir);
+    arguments.AddOption("init", "time spent initializing before reading", settings.init);
+    arguments.AddOption("runs", "number of runs", settings.runs);
+    arguments.AddOption("registrations", "number of times the options are registered", settings.registrations);
+    arguments.AddOption("run", "benchmark to run: all, registration or readahead", settings.run);
+    if (!arguments.Process(argc, argv))
+        return 1;
+
+    if (settings.run == "all" || settings.run == "registration")
+        BenchmarkRegistration(settings);
+    if (settings.run == "all" || settings.run == "readahead")
+        BenchmarkReadAhead(settings);
+    return 0;
+}
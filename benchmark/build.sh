@@ -0,0 +1 @@
+g++ benchmark.cpp -o runbenchmark -I../include --std=c++14 -O2 -pthread -Wall -Wextra
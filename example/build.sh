@@ -1 +1 @@
-g++ example.cpp -o runexample -I../include --std=c++14
+g++ example.cpp -o runexample -I../include --std=c++14 -pthread
@@ -28,23 +28,40 @@ SOFTWARE.
 #define __CYOARGUMENTS_HPP
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <cstring>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <list>
+#include <map>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
-#ifdef _MSC_VER //case insensitivity only on Windows
-#   define strcompare _stricmp
-#   define strncompare _strnicmp
+#ifdef _WIN32
+#   include <fstream>
+#   include <io.h>
+#   include <iterator>
+#   include <sys/stat.h>
 #else
-#   define strcompare std::strcmp
-#   define strncompare std::strncmp
+#   include <dirent.h>
+#   include <fcntl.h>
+#   include <fnmatch.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
 #endif
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -58,17 +75,373 @@ namespace cyoarguments
     template<typename T>
     class Argument;
 
+    class Arguments;
+
     using stringlist = std::list<std::string>;
     using stringlist_iter = stringlist::const_iterator;
+
+    namespace detail
+    {
+        template<typename T>
+        int GetValue(const std::string& arg, T& target);
+
+        // The arguments being processed, which are indexed (to give the argv index of an argument)
+        using arglist = std::vector<std::string>;
+        using arglist_iter = arglist::const_iterator;
+    }
+
+    class ByteSize final
+    {
+    public:
+        ByteSize() = default;
+        explicit ByteSize(std::uint64_t bytes) : bytes_(bytes) { }
+
+        std::uint64_t get() const { return bytes_; }
+
+    private:
+        std::uint64_t bytes_ = 0;
+    };
+
+    template<typename E>
+    struct EnumName
+    {
+        const char* name;
+        E value;
+    };
+
+    template<typename E>
+    class EnumNames final
+    {
+    public:
+        template<std::size_t N>
+        constexpr EnumNames(const EnumName<E> (&names)[N]) : names_(names), size_(N) { }
+
+        const EnumName<E>* begin() const { return names_; }
+        const EnumName<E>* end() const { return names_ + size_; }
+        std::size_t size() const { return size_; }
+
+    private:
+        const EnumName<E>* names_;
+        std::size_t size_;
+    };
+
+    // Specialize enum_names for each enum that is used as an argument, with a static get()
+    // that returns a constexpr table of names and values (see the README)
+    template<typename E>
+    struct enum_names;
+
+    // A string value that doesn't need to be copied, such as the contents of a file given
+    // by --query=@query.sql (which are memory-mapped where possible)
+    class Content final
+    {
+    public:
+        Content() = default;
+        Content(std::shared_ptr<const void> owner, const char* data, std::size_t size)
+            : owner_(std::move(owner)), data_(data), size_(size) { }
+
+        const char* data() const { return data_; }
+        std::size_t size() const { return size_; }
+        bool empty() const { return (size_ == 0); }
+        std::string str() const { return std::string(data_, size_); }
+
+    private:
+        std::shared_ptr<const void> owner_;
+        const char* data_ = "";
+        std::size_t size_ = 0;
+    };
+
+    // The text of the help (descriptions, header, footer and groups), which costs nothing unless
+    // the help is displayed: a text given as Text::Literal is referred to rather than copied (a
+    // char array can't be told apart from a literal, so any other text is copied), and a provider,
+    // such as a lambda that returns a std::string, is only called when the help is displayed
+    class Text final
+    {
+    public:
+        Text() = default;
+
+        // The text must outlive the Arguments that it's given to, as a string literal does
+        static Text Literal(const char* text)
+        {
+            Text literal;
+            literal.text_ = (text != nullptr) ? text : "";
+            return literal;
+        }
+
+        template<typename P, typename std::enable_if<
+            std::is_same<P, const char*>::value || std::is_same<P, char*>::value, int>::type = 0>
+        Text(P text) : Text(std::string((text != nullptr) ? text : "")) { }
+
+        Text(std::string text)
+        {
+            auto owned = std::make_shared<const Owned>(std::move(text));
+            text_ = owned->text.c_str();
+            source_ = std::move(owned);
+        }
+
+        template<typename F, typename std::enable_if<!std::is_convertible<F, std::string>::value
+            && std::is_convertible<decltype(std::declval<F&>()()), std::string>::value, int>::type = 0>
+        Text(F provider)
+            : text_(nullptr), source_(std::make_shared<const Provided<F>>(std::move(provider))) { }
+
+        // A provided text isn't known to be empty until it's been provided
+        bool empty() const { return ((text_ != nullptr) && (*text_ == '\0')); }
+        std::string str() const { return (text_ != nullptr) ? std::string(text_) : source_->get(); }
+
+        friend std::ostream& operator <<(std::ostream& os, const Text& text)
+        {
+            if (text.text_ != nullptr)
+                return os << text.text_;
+            return os << text.source_->get();
+        }
+
+    private:
+        struct Source
+        {
+            virtual ~Source() = default;
+            virtual std::string get() const = 0;
+        };
+
+        struct Owned final : Source
+        {
+            explicit Owned(std::string t) : text(std::move(t)) { }
+            std::string get() const override { return text; }
+            const std::string text;
+        };
+
+        template<typename F>
+        struct Provided final : Source
+        {
+            explicit Provided(F p) : provider(std::move(p)) { }
+            std::string get() const override { return provider(); }
+            F provider;
+        };
+
+        const char* text_ = "";
+        std::shared_ptr<const Source> source_;
+    };
+
+    // The word of an option, or the name of an argument or command: a name given as Name::Literal
+    // is referred to rather than copied, and any other string (including a char array, which can't
+    // be told apart from a literal) is interned by the Arguments that it's added to
+    class Name final
+    {
+    public:
+        // The name must outlive the Arguments that it's added to, as a string literal does
+        static Name Literal(const char* name)
+        {
+            if (name == nullptr)
+                name = "";
+            return Name(name, std::strlen(name));
+        }
+
+        template<typename P, typename std::enable_if<
+            std::is_same<P, const char*>::value || std::is_same<P, char*>::value, int>::type = 0>
+        Name(P name) : Name(std::string((name != nullptr) ? name : "")) { }
+
+        Name(std::string name) : owned_(std::move(name)), data_(nullptr), size_(owned_.size()) { }
+
+        const char* data() const { return (data_ != nullptr) ? data_ : owned_.c_str(); }
+        std::size_t size() const { return size_; }
+
+    private:
+        friend class Arguments;
+
+        Name(const char* data, std::size_t size) : data_(data), size_(size) { }
+
+        std::string owned_;
+        const char* data_;
+        std::size_t size_;
+    };
+
+    // A string value that is known to be valid UTF-8
+    class Utf8String final
+    {
+    public:
+        Utf8String() = default;
+
+        const std::string& get() const { return value_; }
+        const char* data() const { return value_.data(); }
+        std::size_t size() const { return value_.size(); }
+        bool empty() const { return value_.empty(); }
+
+    private:
+        friend int detail::GetValue<>(const std::string&, Utf8String&);
+
+        std::string value_;
+    };
+
+    // Binary data given in hex, such as --key=00ff7f, or in base64, such as --cert=@cert.b64
+    class HexBytes final
+    {
+    public:
+        HexBytes() = default;
+        explicit HexBytes(std::vector<std::uint8_t> bytes) : bytes_(std::move(bytes)) { }
+
+        const std::vector<std::uint8_t>& get() const { return bytes_; }
+        const std::uint8_t* data() const { return bytes_.data(); }
+        std::size_t size() const { return bytes_.size(); }
+        bool empty() const { return bytes_.empty(); }
+
+    private:
+        std::vector<std::uint8_t> bytes_;
+    };
+
+    class Base64Bytes final
+    {
+    public:
+        Base64Bytes() = default;
+        explicit Base64Bytes(std::vector<std::uint8_t> bytes) : bytes_(std::move(bytes)) { }
+
+        const std::vector<std::uint8_t>& get() const { return bytes_; }
+        const std::uint8_t* data() const { return bytes_.data(); }
+        std::size_t size() const { return bytes_.size(); }
+        bool empty() const { return bytes_.empty(); }
+
+    private:
+        std::vector<std::uint8_t> bytes_;
+    };
+
+    // The checks that are made on a Path once all the arguments have been processed
+    // (PathReadAhead isn't a check: it starts reading the file into the page cache as soon
+    // as the path is parsed, for a file that will be read after processing the arguments)
+    enum PathCheck : unsigned
+    {
+        PathExists = 1,
+        PathIsFile = 2,
+        PathIsDirectory = 4,
+        PathIsReadable = 8,
+        PathReadAhead = 16
+    };
+
+    // A file or directory, such as Path<PathIsFile | PathIsReadable>
+    template<unsigned Checks = 0>
+    class Path final
+    {
+    public:
+        static const unsigned checks = Checks;
+
+        Path() = default;
+        explicit Path(std::string path) : path_(std::move(path)) { }
+
+        const std::string& get() const { return path_; }
+        const char* c_str() const { return path_.c_str(); }
+        bool empty() const { return path_.empty(); }
+
+    private:
+        std::string path_;
+    };
+
+    // The expansion of the values of a list of strings or paths, for programs that aren't started
+    // by a shell: glob patterns such as data/*.csv, and/or directories (recursively), optionally
+    // sorting the paths that each value expands to
+    enum ListExpand : unsigned
+    {
+        ExpandGlob = 1,
+        ExpandDirectory = 2,
+        ExpandSorted = 4
+    };
+
+    // Any list can read values from stdin, given as -, one per line (or NUL-separated, as output by
+    // find -print0); these can be combined with the expansions above by lists of strings or paths
+    enum ListStdin : unsigned
+    {
+        ExpandStdin = 8,
+        ExpandStdinNul = 16
+    };
+
+    // Counts the occurrences of an option, such as -vvv
+    class Counter final
+    {
+    public:
+        Counter() = default;
+        explicit Counter(int count) : count_(count) { }
+
+        int get() const { return count_; }
+        void increment() { ++count_; }
+
+    private:
+        int count_ = 0;
+    };
+
+    // A set of indexes stored as a bitmap, such as --cpus=0-7,16-23,32 or --workers=0-30:2
+    // (on 64-bit Linux, words() has the same layout as a cpu_set_t)
+    class IndexSet final
+    {
+    public:
+        static const std::size_t maxIndex = (1 << 20) - 1;
+
+        bool empty() const { return words_.empty(); }
+        bool test(std::size_t index) const;
+        std::size_t count() const;
+        const std::vector<std::uint64_t>& words() const { return words_; }
+
+        void set(std::size_t index) { set(index, index, 1); }
+        void set(std::size_t first, std::size_t last, std::size_t stride);
+        void merge(const IndexSet& other);
+
+    private:
+        static const std::size_t bitsPerWord = 64;
+
+        std::vector<std::uint64_t> words_;
+    };
+
+    // The arguments that follow --, as pointers into the original argv (which ends with a null
+    // pointer, so data() can be passed straight to execv); for a command line that isn't an
+    // argv array, data() is null but index() and size() still identify the arguments
+    class ArgumentSpan final
+    {
+    public:
+        ArgumentSpan() = default;
+        ArgumentSpan(char* const* data, std::size_t index, std::size_t size)
+            : data_(data), index_(index), size_(size) { }
+
+        char* const* data() const { return data_; }
+        std::size_t index() const { return index_; }
+        std::size_t size() const { return size_; }
+        bool empty() const { return (size_ == 0); }
+
+        char* const* begin() const { return data_; }
+        char* const* end() const { return data_ + size_; }
+        const char* operator [](std::size_t index) const { return data_[index]; }
+
+    private:
+        char* const* data_ = nullptr;
+        std::size_t index_ = 0;
+        std::size_t size_ = 0;
+    };
+
+#ifndef _WIN32
+    // Reads command lines, such as /proc/<pid>/cmdline, into a buffer that's reused for each
+    // one (usually with a single read) so that many can be passed to the same Arguments
+    class CmdlineReader final
+    {
+    public:
+        bool Read(const char* path);
+        bool Read(int pid);
+
+        const char* data() const { return buffer_.data(); }
+        std::size_t size() const { return size_; }
+
+    private:
+        std::vector<char> buffer_ = std::vector<char>(4096);
+        std::size_t size_ = 0;
+    };
+#endif
 }
 
+#include "detail/base.hpp"
 #include "detail/traits.hpp"
+#include "detail/file.hpp"
+#include "detail/encoding.hpp"
+#include "detail/path.hpp"
 #include "detail/getvalue.hpp"
+#include "detail/expand.hpp"
 
-#include "detail/base.hpp"
 #include "detail/option.hpp"
+#include "detail/words.hpp"
 #include "detail/required.hpp"
 #include "detail/list.hpp"
+#include "detail/command.hpp"
 
 namespace cyoarguments
 {
@@ -86,56 +459,135 @@ namespace cyoarguments
 
         void SetVersion(std::string version);
 
-        void SetHeader(std::string header);
+        void SetHeader(Text header);
+
+        void SetFooter(Text footer);
 
-        void SetFooter(std::string footer);
+        // Ignores the case of options (which is the default on Windows), on any platform;
+        // this must be set before any options are added
+        void SetIgnoreCase(bool ignoreCase);
 
-        void AddGroup(std::string group);
+        void AddGroup(Text group);
+
+        // Adds the options of a module, such as a library, under a group of its own; the
+        // registrar is called with these Arguments (conflicts with the options of other
+        // modules are reported as duplicates, naming the module)
+        template<typename Registrar>
+        void AddModule(std::string name, Registrar registrar);
+
+        template<typename T>
+        void AddOption(char letter, Name word, Text description, T& target);
 
         template<typename T>
-        void AddOption(char letter, std::string word, std::string description, T& target);
+        void AddOption(char letter, Text description, T& target);
 
         template<typename T>
-        void AddOption(char letter, std::string description, T& target);
+        void AddOption(Name word, Text description, T& target);
 
         template<typename T>
-        void AddOption(std::string word, std::string description, T& target);
+        typename std::enable_if<detail::allow_list_argument<T>::value>::type
+            AddOption(char letter, Name word, Text description, T& target, char delimiter);
 
         template<typename T>
-        void AddRequired(std::string name, std::string description, T& target);
+        typename std::enable_if<detail::allow_list_argument<T>::value>::type
+            AddOption(char letter, Text description, T& target, char delimiter);
 
         template<typename T>
-        void AddList(std::string name, std::string description, T& target);
+        typename std::enable_if<detail::allow_list_argument<T>::value>::type
+            AddOption(Name word, Text description, T& target, char delimiter);
+
+        void AddFlag(char letter, Name word, Text description, std::uint64_t& flags, std::uint64_t mask);
+
+        void AddFlag(char letter, Text description, std::uint64_t& flags, std::uint64_t mask);
+
+        void AddFlag(Name word, Text description, std::uint64_t& flags, std::uint64_t mask);
+
+        // Adds a command, such as build in "tool build --jobs=4", selected by the first argument
+        // that isn't an option; the registrar is only called with the command's own Arguments
+        // once the command has been selected (it can't be combined with required or list arguments)
+        template<typename Registrar>
+        void AddCommand(Name name, Text description, Registrar registrar);
+
+        template<typename T>
+        void AddRequired(Name name, Text description, T& target);
+
+        template<typename T>
+        void AddList(Name name, Text description, T& target);
+
+        template<typename T>
+        void AddList(Name name, Text description, T& target, unsigned expand);
+
+        template<typename T>
+        void AddList(Name name, Text description, T& target, ListStdin expand);
+
+        void AddPassthrough(Name name, Text description, ArgumentSpan& target);
+
+        // Collects the argv indexes of unknown options and unexpected arguments, in order,
+        // rather than failing (an option with an invalid value still fails)
+        void CollectUnknown(std::vector<int>& indexes);
 
         bool Process(int argc, char* argv[], std::string& error) const;
 
         bool Process(int argc, char* argv[]) const;
 
+        // Processes a NUL-separated command line, such as /proc/<pid>/cmdline, which starts with the
+        // program name (as argv does); it's only data, so help and version aren't displayed (they're
+        // returned as errors), and no file, stdin or directory is read for its values
+        bool Process(const char* cmdline, std::size_t size, std::string& error) const;
+
+        // The words of the options under a prefix (such as db.pool, for db.pool.size and
+        // db.pool.timeout), in the order they were added; an empty prefix gives every word
+        stringlist GetOptionWords(std::string prefix) const;
+
     private:
         bool helpEnabled_ = true;
+#ifdef _MSC_VER //case is ignored by default on Windows
+        bool ignoreCase_ = true;
+#else
+        bool ignoreCase_ = false;
+#endif
         std::string name_;
         std::string version_;
-        std::string header_;
-        std::string footer_;
+        Text header_;
+        Text footer_;
         detail::OptionsList options_;
         detail::RequiredList required_;
         detail::ListPtr list_;
+        detail::PassthroughPtr passthrough_;
+        detail::CommandsList commands_;
+        std::unordered_map<detail::StringRef, const detail::Command*, detail::StringRefHash> commandIndex_;
+        std::vector<int>* unknown_ = nullptr;
+        detail::FlagLetters flagLetters_;
+        detail::WordTree words_;
+        std::unordered_set<std::string> names_;
+        const detail::OptionBase* letterIndex_[detail::numLetters] = {};
+        std::string module_;
         bool allowEmpty_ = false;
         int numGroups_ = 0;
 
         void VerifyLetter(char letter);
-        void VerifyWord(const std::string& word);
-        void VerifyRequired(const std::string& name);
-        void VerifyList(const std::string& name);
-        bool ProcessImpl(int argc, char* argv[], std::string& error) const;
-        bool FindHelpOrVersion(const stringlist& args) const;
-        void DisplayHelp() const;
+        void VerifyWord(const detail::StringRef& word);
+        void VerifyWords(const Name& words, bool negatable);
+        void VerifyRequired(const Name& name);
+        void VerifyList(const Name& name);
+        void VerifyCommand(const Name& name);
+        detail::StringRef Intern(Name name);
+        detail::StringRef InternWord(Name word);
+        bool ProcessImpl(detail::arglist& args, int argc, char* argv[], detail::ProcessState& state, std::string& error) const;
+        bool ProcessRange(const detail::arglist& args, detail::arglist_iter first, detail::arglist_iter last, int argc, char* argv[], std::string& error) const;
+        bool FindHelpOrVersion(detail::arglist_iter currArg, const detail::arglist_iter& lastArg, std::string& error) const;
+        bool ProcessHelpOrVersion(const std::string& arg, std::string& error) const;
+        void DisplayHelp(std::string prefix) const;
         void DisplayVersion() const;
-        bool ProcessOptions(stringlist_iter& currArg, const stringlist_iter& lastArg) const;
-        bool ProcessWord(stringlist_iter& currArg, const stringlist_iter& lastArg, int& ch) const;
-        bool ProcessLetters(stringlist_iter& currArg, const stringlist_iter& lastArg, int& ch) const;
-        bool ProcessRequired(stringlist_iter& currArg, const stringlist_iter& lastArg, detail::RequiredList::const_iterator& it) const;
-        bool ProcessList(stringlist_iter& currArg, const stringlist_iter& lastArg) const;
+        bool ProcessOptions(detail::arglist_iter& currArg, const detail::arglist_iter& lastArg, bool& unknown) const;
+        bool ProcessWord(detail::arglist_iter& currArg, const detail::arglist_iter& lastArg, int& ch, bool& unknown) const;
+        void AddOptionImpl(char letter, detail::StringRef word, detail::OptionPtr option);
+        void AddFlagImpl(char letter, detail::StringRef word, Text description, std::uint64_t& flags, std::uint64_t mask);
+        bool ProcessFlagLetters(const std::string& arg, int ch) const;
+        bool ProcessLetters(detail::arglist_iter& currArg, const detail::arglist_iter& lastArg, int& ch, bool& unknown) const;
+        bool ProcessRequired(detail::arglist_iter& currArg, const detail::arglist_iter& lastArg, detail::RequiredList::const_iterator& it) const;
+        bool ProcessList(detail::arglist_iter& currArg, const detail::arglist_iter& lastArg) const;
+        bool ProcessCommand(const detail::arglist& args, detail::arglist_iter commandArg, detail::arglist_iter lastArg, int argc, char* argv[], std::string& error) const;
     };
 
     template<typename T>
@@ -33,6 +33,100 @@ namespace cyoarguments
 {
     namespace detail
     {
+        // InvalidValue is thrown when a value is definitely invalid, to explain why
+        // (it's caught while processing the arguments, and the reason added to the error)
+        class InvalidValue final : public std::runtime_error
+        {
+        public:
+            explicit InvalidValue(const std::string& reason) : std::runtime_error(reason) { }
+        };
+
+        // A string that isn't owned: a literal, a string interned by Arguments, or part of an argument
+        // (only the first two are terminated, so c_str() is only for them)
+        class StringRef final
+        {
+        public:
+            StringRef() = default;
+            StringRef(const char* data, std::size_t size) : data_(data), size_(size) { }
+
+            const char* data() const { return data_; }
+            const char* c_str() const { return data_; }
+            std::size_t size() const { return size_; }
+            bool empty() const { return (size_ == 0); }
+            std::string str() const { return std::string(data_, size_); }
+
+            bool operator ==(const StringRef& other) const
+            {
+                return (size_ == other.size_) && (std::memcmp(data_, other.data_, size_) == 0);
+            }
+
+            friend std::ostream& operator <<(std::ostream& os, const StringRef& str)
+            {
+                return os.write(str.data_, (std::streamsize)str.size_);
+            }
+
+        private:
+            const char* data_ = "";
+            std::size_t size_ = 0;
+        };
+
+        struct StringRefHash
+        {
+            std::size_t operator ()(const StringRef& str) const
+            {
+                // FNV-1a
+                std::uint64_t hash = 14695981039346656037ull;
+                for (std::size_t index = 0; index < str.size(); ++index)
+                    hash = (hash ^ (unsigned char)str.data()[index]) * 1099511628211ull;
+                return (std::size_t)hash;
+            }
+        };
+
+        // A path that was given as a value, and the checks to make on it
+        struct PathToCheck
+        {
+            std::string path;
+            unsigned checks;
+        };
+
+        // The state of the arguments being processed by this thread, which the values reach without
+        // it being passed through every GetValue (the paths are recorded as they're parsed, so only
+        // the values that were given are checked, rather than defaults or earlier values)
+        struct ProcessState
+        {
+            std::vector<PathToCheck> paths;
+            bool dataOnly = false; //see IsDataOnly
+        };
+
+        inline ProcessState*& CurrentProcessState()
+        {
+            static thread_local ProcessState* state = nullptr;
+            return state;
+        }
+
+        // A command line from a buffer (such as another process's) is only data: nothing is displayed,
+        // and its values aren't looked up in the file system (@path and - are values, globs and
+        // directories aren't expanded, and paths are neither read ahead nor checked)
+        inline bool IsDataOnly()
+        {
+            const ProcessState* state = CurrentProcessState();
+            return (state != nullptr) && state->dataOnly;
+        }
+
+        // Makes a state current while arguments are processed (restoring any previous state after)
+        class ScopedProcessState final
+        {
+        public:
+            ScopedProcessState(const ScopedProcessState&) = delete;
+            ScopedProcessState& operator =(const ScopedProcessState&) = delete;
+
+            explicit ScopedProcessState(ProcessState& state) : previous_(CurrentProcessState()) { CurrentProcessState() = &state; }
+            ~ScopedProcessState() { CurrentProcessState() = previous_; }
+
+        private:
+            ProcessState* previous_;
+        };
+
         class ArgumentBase
         {
         public:
@@ -40,7 +134,7 @@ namespace cyoarguments
 
             virtual void OutputUsage() const = 0;
             virtual void OutputHelp() const = 0;
-            virtual bool Process(stringlist_iter& currArg, const stringlist_iter& lastArg, int& ch, bool word, bool& error) const = 0;
+            virtual bool Process(arglist_iter& currArg, const arglist_iter& lastArg, int& ch, bool word, bool& error) const = 0;
 
         protected:
             static const std::size_t optionWidth_ = 20;
@@ -0,0 +1,93 @@
+/*
+[CyoArguments] detail/command.hpp
+
+The MIT License (MIT)
+
+Copyright (c) 2015-2016 Graham Bull
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __CYOARGUMENTS_COMMAND_HPP
+#define __CYOARGUMENTS_COMMAND_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cyoarguments
+{
+    namespace detail
+    {
+        class Command final : public ArgumentBase
+        {
+        public:
+            Command(StringRef name, Text description, std::function<void(Arguments&)> registrar)
+                : name_(name),
+                description_(std::move(description)),
+                registrar_(std::move(registrar))
+            {
+            }
+
+            StringRef getName() const { return name_; }
+            const Text& getDescription() const { return description_; }
+
+            void OutputUsage() const override
+            {
+                std::cout << " COMMAND [ARG...]";
+            }
+
+            void OutputHelp() const override
+            {
+                std::cout << "  " << name_;
+                for (auto i = name_.size(); i < optionWidth_; ++i)
+                    std::cout << ' ';
+                std::cout << description_;
+                std::cout << '\n';
+            }
+
+            bool Process(arglist_iter& currArg, const arglist_iter& lastArg, int& ch, bool word, bool& error) const override
+            {
+                UNREFERENCED_PARAMETER(currArg);
+                UNREFERENCED_PARAMETER(lastArg);
+                UNREFERENCED_PARAMETER(ch);
+                UNREFERENCED_PARAMETER(word);
+                error = false;
+                return false; //the arguments are processed by the command's own Arguments
+            }
+
+            // Adds the command's arguments, which is only done once the command is selected
+            void Register(Arguments& arguments) const
+            {
+                registrar_(arguments);
+            }
+
+        private:
+            const StringRef name_;
+            const Text description_;
+            const std::function<void(Arguments&)> registrar_;
+        };
+
+        using CommandPtr = std::unique_ptr<Command>;
+
+        using CommandsList = std::vector<CommandPtr>;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif //__CYOARGUMENTS_COMMAND_HPP
@@ -31,6 +31,102 @@ SOFTWARE.
 
 namespace cyoarguments
 {
+    // IndexSet
+
+    inline bool IndexSet::test(std::size_t index) const
+    {
+        const std::size_t word = index / bitsPerWord;
+        return (word < words_.size()) && ((words_[word] >> (index % bitsPerWord)) & 1);
+    }
+
+    inline std::size_t IndexSet::count() const
+    {
+        std::size_t count = 0;
+        for (auto word : words_)
+        {
+            for (; word != 0; word &= (word - 1))
+                ++count;
+        }
+        return count;
+    }
+
+    inline void IndexSet::set(std::size_t first, std::size_t last, std::size_t stride)
+    {
+        assert(first <= last && last <= maxIndex && stride >= 1);
+
+        const std::size_t firstWord = first / bitsPerWord;
+        const std::size_t lastWord = last / bitsPerWord;
+        if (words_.size() <= lastWord)
+            words_.resize(lastWord + 1);
+
+        if (stride != 1)
+        {
+            for (auto index = first; index <= last; index += stride)
+                words_[index / bitsPerWord] |= (std::uint64_t)1 << (index % bitsPerWord);
+            return;
+        }
+
+        // Contiguous ranges are set a word at a time
+        const std::uint64_t allBits = ~(std::uint64_t)0;
+        const std::uint64_t firstMask = allBits << (first % bitsPerWord);
+        const std::uint64_t lastMask = allBits >> (bitsPerWord - 1 - (last % bitsPerWord));
+        if (firstWord == lastWord)
+            words_[firstWord] |= (firstMask & lastMask);
+        else
+        {
+            words_[firstWord] |= firstMask;
+            std::fill(words_.begin() + firstWord + 1, words_.begin() + lastWord, allBits);
+            words_[lastWord] |= lastMask;
+        }
+    }
+
+    inline void IndexSet::merge(const IndexSet& other)
+    {
+        if (words_.size() < other.words_.size())
+            words_.resize(other.words_.size());
+        for (std::size_t word = 0; word < other.words_.size(); ++word)
+            words_[word] |= other.words_[word];
+    }
+
+#ifndef _WIN32
+    // CmdlineReader
+
+    inline bool CmdlineReader::Read(const char* path)
+    {
+        size_ = 0;
+        int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+
+        // A read that doesn't fill the buffer has reached the end of the command line
+        bool ok = true;
+        for (;;)
+        {
+            const ssize_t len = ::read(fd, buffer_.data() + size_, buffer_.size() - size_);
+            if (len < 0 && errno == EINTR)
+                continue;
+            if (len < 0)
+            {
+                ok = false;
+                break;
+            }
+            size_ += (std::size_t)len;
+            if (size_ < buffer_.size())
+                break;
+            buffer_.resize(buffer_.size() * 2);
+        }
+        ::close(fd);
+        return ok;
+    }
+
+    inline bool CmdlineReader::Read(int pid)
+    {
+        char path[32];
+        std::snprintf(path, sizeof(path), "/proc/%d/cmdline", pid);
+        return Read(path);
+    }
+
+#endif
     // public members
 
     inline void Arguments::DisableHelp()
@@ -48,75 +144,233 @@ namespace cyoarguments
         version_ = std::move(version);
     }
 
-    inline void Arguments::SetHeader(std::string header)
+    inline void Arguments::SetHeader(Text header)
     {
         header_ = std::move(header);
     }
 
-    inline void Arguments::SetFooter(std::string footer)
+    inline void Arguments::SetFooter(Text footer)
     {
         footer_ = std::move(footer);
     }
 
-    inline void Arguments::AddGroup(std::string group)
+    inline void Arguments::SetIgnoreCase(bool ignoreCase)
+    {
+        if (!options_.empty())
+            throw std::logic_error("Case must be ignored before adding options");
+        ignoreCase_ = ignoreCase;
+    }
+
+    template<typename Registrar>
+    inline void Arguments::AddModule(std::string name, Registrar registrar)
     {
-        options_.push_back(std::make_unique<detail::Group>(group));
+        if (!module_.empty())
+            throw std::logic_error("Modules cannot be nested");
+        AddGroup(name);
+        module_ = std::move(name);
+        try
+        {
+            registrar(*this);
+        }
+        catch (...)
+        {
+            module_.clear();
+            throw;
+        }
+        module_.clear();
+    }
+
+    inline void Arguments::AddGroup(Text group)
+    {
+        options_.push_back(std::make_unique<detail::Group>(std::move(group)));
         ++numGroups_;
     }
 
     template<typename T>
-    inline void Arguments::AddOption(char letter, std::string word, std::string description, T& target)
+    inline void Arguments::AddOption(char letter, Name word, Text description, T& target)
     {
         VerifyLetter(letter);
-        VerifyWord(word);
-        options_.push_back(std::make_unique<detail::Option<T>>(letter, word, description, target));
+        VerifyWords(word, detail::is_negatable<T>::value);
+        const detail::StringRef ref = InternWord(std::move(word));
+        AddOptionImpl(letter, ref, std::make_unique<detail::Option<T>>(letter, ref, std::move(description), target));
     }
 
     template<typename T>
-    inline void Arguments::AddOption(char letter, std::string description, T& target)
+    inline void Arguments::AddOption(char letter, Text description, T& target)
     {
         VerifyLetter(letter);
-        options_.push_back(std::make_unique<detail::Option<T>>(letter, description, target));
+        AddOptionImpl(letter, detail::StringRef(), std::make_unique<detail::Option<T>>(letter, std::move(description), target));
+    }
+
+    template<typename T>
+    inline void Arguments::AddOption(Name word, Text description, T& target)
+    {
+        VerifyWords(word, detail::is_negatable<T>::value);
+        const detail::StringRef ref = InternWord(std::move(word));
+        AddOptionImpl('\0', ref, std::make_unique<detail::Option<T>>('\0', ref, std::move(description), target));
     }
 
     template<typename T>
-    inline void Arguments::AddOption(std::string word, std::string description, T& target)
+    inline typename std::enable_if<detail::allow_list_argument<T>::value>::type
+        Arguments::AddOption(char letter, Name word, Text description, T& target, char delimiter)
     {
-        VerifyWord(word);
-        options_.push_back(std::make_unique<detail::Option<T>>('\0', word, description, target));
+        VerifyLetter(letter);
+        VerifyWords(word, false);
+        const detail::StringRef ref = InternWord(std::move(word));
+        AddOptionImpl(letter, ref, std::make_unique<detail::Option<T>>(letter, ref, std::move(description), target, delimiter));
     }
 
     template<typename T>
-    inline void Arguments::AddRequired(std::string name, std::string description, T& target)
+    inline typename std::enable_if<detail::allow_list_argument<T>::value>::type
+        Arguments::AddOption(char letter, Text description, T& target, char delimiter)
+    {
+        VerifyLetter(letter);
+        AddOptionImpl(letter, detail::StringRef(), std::make_unique<detail::Option<T>>(letter, std::move(description), target, delimiter));
+    }
+
+    template<typename T>
+    inline typename std::enable_if<detail::allow_list_argument<T>::value>::type
+        Arguments::AddOption(Name word, Text description, T& target, char delimiter)
+    {
+        VerifyWords(word, false);
+        const detail::StringRef ref = InternWord(std::move(word));
+        AddOptionImpl('\0', ref, std::make_unique<detail::Option<T>>('\0', ref, std::move(description), target, delimiter));
+    }
+
+    inline void Arguments::AddFlag(char letter, Name word, Text description, std::uint64_t& flags, std::uint64_t mask)
+    {
+        VerifyLetter(letter);
+        VerifyWords(word, true);
+        AddFlagImpl(letter, InternWord(std::move(word)), std::move(description), flags, mask);
+    }
+
+    inline void Arguments::AddFlag(char letter, Text description, std::uint64_t& flags, std::uint64_t mask)
+    {
+        VerifyLetter(letter);
+        AddFlagImpl(letter, detail::StringRef(), std::move(description), flags, mask);
+    }
+
+    inline void Arguments::AddFlag(Name word, Text description, std::uint64_t& flags, std::uint64_t mask)
+    {
+        VerifyWords(word, true);
+        AddFlagImpl('\0', InternWord(std::move(word)), std::move(description), flags, mask);
+    }
+
+    template<typename Registrar>
+    inline void Arguments::AddCommand(Name name, Text description, Registrar registrar)
+    {
+        VerifyCommand(name);
+        if (commandIndex_.count(detail::StringRef(name.data(), name.size())) != 0)
+            throw std::logic_error("Duplicate command: " + std::string(name.data(), name.size()));
+        const detail::StringRef ref = Intern(std::move(name));
+        commands_.push_back(std::make_unique<detail::Command>(ref, std::move(description), std::function<void(Arguments&)>(std::move(registrar))));
+        commandIndex_.emplace(ref, commands_.back().get());
+    }
+
+    template<typename T>
+    inline void Arguments::AddRequired(Name name, Text description, T& target)
     {
         static_assert(detail::allow_required_argument<T>::value, "Disallowed type of required argument");
         VerifyRequired(name);
-        required_.push_back(std::make_unique<detail::Required<T>>(name, description, target));
+        required_.push_back(std::make_unique<detail::Required<T>>(Intern(std::move(name)), std::move(description), target));
     }
 
     template<typename T>
-    inline void Arguments::AddList(std::string name, std::string description, T& target)
+    inline void Arguments::AddList(Name name, Text description, T& target)
     {
         static_assert(detail::allow_list_argument<T>::value, "Disallowed type of list argument");
         VerifyList(name);
-        list_ = std::make_unique<detail::List<T>>(name, description, target);
+        list_ = std::make_unique<detail::List<T>>(Intern(std::move(name)), std::move(description), target);
+    }
+
+    template<typename T>
+    inline void Arguments::AddList(Name name, Text description, T& target, unsigned expand)
+    {
+        static_assert(detail::allow_list_expansion<T>::value, "Only lists of strings or paths can expand globs or directories");
+        VerifyList(name);
+        list_ = std::make_unique<detail::List<T>>(Intern(std::move(name)), std::move(description), target, expand);
+    }
+
+    template<typename T>
+    inline void Arguments::AddList(Name name, Text description, T& target, ListStdin expand)
+    {
+        static_assert(detail::allow_list_argument<T>::value, "Disallowed type of list argument");
+        VerifyList(name);
+        list_ = std::make_unique<detail::List<T>>(Intern(std::move(name)), std::move(description), target, expand);
+    }
+
+    inline void Arguments::AddPassthrough(Name name, Text description, ArgumentSpan& target)
+    {
+        if (passthrough_)
+            throw std::logic_error("Only one passthrough argument can be specified");
+        if (name.size() == 0)
+            throw std::logic_error("Passthrough argument must have a name");
+        passthrough_ = std::make_unique<detail::Passthrough>(Intern(std::move(name)), std::move(description), target);
+    }
+
+    inline void Arguments::CollectUnknown(std::vector<int>& indexes)
+    {
+        unknown_ = &indexes;
     }
 
     inline bool Arguments::Process(int argc, char* argv[], std::string& error) const
     {
-        return ProcessImpl(argc, argv, error);
+        // The arguments that are passed through aren't copied
+        detail::arglist args;
+        args.reserve(argc > 1 ? argc - 1 : 0);
+        for (int index = 1; index < argc; ++index)
+        {
+            args.emplace_back(argv[index]);
+            if (passthrough_ && args.back() == "--")
+                break;
+        }
+        detail::ProcessState state;
+        return ProcessImpl(args, argc, argv, state, error);
     }
 
     inline bool Arguments::Process(int argc, char* argv[]) const
     {
         std::string error;
-        if (ProcessImpl(argc, argv, error))
+        if (Process(argc, argv, error))
             return true;
         if (!error.empty())
             std::cerr << error << std::endl;
         return false;
     }
 
+    inline bool Arguments::Process(const char* cmdline, std::size_t size, std::string& error) const
+    {
+        // The arguments are taken straight from the buffer, without building an argv array
+        // (the last one needn't be terminated)
+        const char* const endptr = cmdline + size;
+        auto ptr = (const char*)std::memchr(cmdline, '\0', size);
+        ptr = (ptr != nullptr) ? ptr + 1 : endptr; //skip the program name
+
+        detail::arglist args;
+        args.reserve(std::count(ptr, endptr, '\0') + 1);
+        while (ptr != endptr)
+        {
+            auto nextptr = (const char*)std::memchr(ptr, '\0', endptr - ptr);
+            if (nextptr == nullptr)
+                nextptr = endptr;
+            args.emplace_back(ptr, nextptr);
+            ptr = (nextptr != endptr) ? nextptr + 1 : endptr;
+        }
+        detail::ProcessState state;
+        state.dataOnly = true;
+        return ProcessImpl(args, 0, nullptr, state, error);
+    }
+
+    inline stringlist Arguments::GetOptionWords(std::string prefix) const
+    {
+        if (ignoreCase_)
+            detail::FoldCase(&prefix[0], prefix.size());
+        stringlist words;
+        for (const auto& entry : words_.Collect(detail::StringRef(prefix.c_str(), prefix.size())))
+            words.push_back(entry.word.str());
+        return words;
+    }
+
     // private members
 
     inline void Arguments::VerifyLetter(char letter)
@@ -125,125 +379,373 @@ namespace cyoarguments
             throw std::logic_error(std::string("Option is not alphanumeric: ") + letter);
     }
 
-    inline void Arguments::VerifyWord(const std::string& word)
+    inline void Arguments::VerifyWord(const detail::StringRef& word)
     {
+        const char* const end = word.data() + word.size();
         if (word.empty())
             throw std::logic_error("Option cannot be blank");
-        if (std::find_if(word.begin(), word.end(), [](char ch){ return !std::isalnum(ch); }) != word.end())
-            throw std::logic_error(std::string("Option contains a non-alphanumeric character: ") + word);
+        if (std::find_if(word.data(), end, [](char ch){ return !std::isalnum(ch) && ch != '.'; }) != end)
+            throw std::logic_error("Option contains a non-alphanumeric character: " + word.str());
+        // Dots separate segments, such as db.pool.size
+        if (word.data()[0] == '.' || end[-1] == '.' || std::search_n(word.data(), end, 2, '.') != end)
+            throw std::logic_error("Option contains an empty segment: " + word.str());
+    }
+
+    inline void Arguments::VerifyWords(const Name& words, bool negatable)
+    {
+        // The spellings of a word are separated by bars (such as verbose|chatty), and a boolean
+        // option can also be negated (such as [no-]color, for --color and --no-color)
+        if (words.size() == 0)
+            throw std::logic_error("Option cannot be blank");
+        detail::OptionBase::ForEachSpelling(words.data(), [this, negatable](const char* spelling, std::size_t size)
+        {
+            if (size >= 5 && std::strncmp(spelling, "[no-]", 5) == 0)
+            {
+                if (!negatable)
+                    throw std::logic_error("Only boolean options can be negated: " + std::string(spelling, size));
+                spelling += 5;
+                size -= 5;
+            }
+            VerifyWord(detail::StringRef(spelling, size));
+        });
+    }
+
+    inline detail::StringRef Arguments::Intern(Name name)
+    {
+        // Literal names are referred to, and others are kept (once) for the lifetime of the Arguments
+        if (name.data_ != nullptr)
+            return detail::StringRef(name.data_, name.size_);
+        const std::string& interned = *names_.insert(std::move(name.owned_)).first;
+        return detail::StringRef(interned.c_str(), interned.size());
+    }
+
+    inline detail::StringRef Arguments::InternWord(Name word)
+    {
+        // When case is ignored, a word with capitals is kept with its folded copy after it, so
+        // the help shows the word as it was given
+        const detail::StringRef ref(word.data(), word.size());
+        if (!ignoreCase_ || !detail::HasCapitals(ref))
+            return Intern(std::move(word));
+        std::string folded = ref.str();
+        detail::FoldCase(&folded[0], folded.size());
+        const std::string& interned = *names_.insert(ref.str() + '\0' + folded).first;
+        return detail::StringRef(interned.c_str(), ref.size());
+    }
+
+    inline void Arguments::AddFlagImpl(char letter, detail::StringRef word, Text description, std::uint64_t& flags, std::uint64_t mask)
+    {
+        if (mask == 0)
+            throw std::logic_error("Flag must have a mask");
+
+        AddOptionImpl(letter, word, std::make_unique<detail::Flag>(letter, word, std::move(description), flags, mask));
+
+        if (letter != '\0')
+        {
+            if (!flagLetters_)
+                flagLetters_.reset(new detail::FlagLetter[detail::numLetters]);
+            flagLetters_[(unsigned char)letter] = { &flags, mask };
+            if (ignoreCase_)
+            {
+                flagLetters_[std::tolower(letter)] = { &flags, mask };
+                flagLetters_[std::toupper(letter)] = { &flags, mask };
+            }
+        }
+    }
+
+    inline void Arguments::AddOptionImpl(char letter, detail::StringRef word, detail::OptionPtr option)
+    {
+        // Conflicts are found before anything is changed
+        const std::string inModule = module_.empty() ? "" : " (in module " + module_ + ")";
+        const unsigned char lower = (unsigned char)(ignoreCase_ ? std::tolower(letter) : letter);
+        const unsigned char upper = (unsigned char)(ignoreCase_ ? std::toupper(letter) : letter);
+        if (letter != '\0' && (letterIndex_[lower] != nullptr || letterIndex_[upper] != nullptr))
+            throw std::logic_error(std::string("Duplicate option: ") + letter + inModule);
+        // Each spelling of a word (such as verbose|chatty, or [no-]color for color and no-color) is
+        // a key that leads to the option, as it was added or, when case is ignored, folded
+        const bool folded = ignoreCase_ && detail::HasCapitals(word);
+        const detail::StringRef spellings = folded ? detail::StringRef(word.data() + word.size() + 1, word.size()) : word;
+        std::vector<std::pair<std::string, bool>> keys; //only for several spellings (and whether each is negated)
+        if (std::find_if(spellings.data(), spellings.data() + spellings.size(), [](char ch) { return (ch == '|' || ch == '['); })
+            != spellings.data() + spellings.size())
+        {
+            detail::OptionBase::ForEachSpelling(spellings.c_str(), [&keys](const char* spelling, std::size_t size)
+            {
+                if (std::strncmp(spelling, "[no-]", 5) == 0)
+                {
+                    keys.emplace_back(std::string(spelling + 5, size - 5), false);
+                    keys.emplace_back("no-" + keys.back().first, true);
+                }
+                else
+                    keys.emplace_back(std::string(spelling, size), false);
+            });
+        }
+        if (keys.empty() && !word.empty() && words_.Find(spellings) != nullptr)
+            throw std::logic_error("Duplicate option: " + word.str() + inModule);
+        for (auto key = keys.begin(); key != keys.end(); ++key)
+        {
+            if (words_.Find(detail::StringRef(key->first.c_str(), key->first.size())) != nullptr
+                || std::find_if(keys.begin(), key, [&key](const std::pair<std::string, bool>& other) { return (other.first == key->first); }) != key)
+                throw std::logic_error("Duplicate option: " + key->first + inModule);
+        }
+
+        // The words of the options under a prefix are given by their first spellings
+        const char* const first = word.data() + ((std::strncmp(word.data(), "[no-]", 5) == 0) ? 5 : 0);
+        const detail::StringRef firstSpelling(first, std::strcspn(first, "|"));
+
+        if (ignoreCase_)
+            option->IgnoreCase();
+        options_.push_back(std::move(option));
+        const std::size_t order = options_.size() - 1;
+        if (letter != '\0')
+            letterIndex_[lower] = letterIndex_[upper] = options_.back().get();
+        if (keys.empty() && !word.empty())
+            words_.Add(spellings, { options_.back().get(), firstSpelling, order, false });
+        for (auto& key : keys)
+            words_.Add(Intern(std::move(key.first)), { options_.back().get(), firstSpelling, order, key.second });
     }
 
-    inline void Arguments::VerifyRequired(const std::string& name)
+    inline void Arguments::VerifyRequired(const Name& name)
     {
-        if (name.empty())
+        if (!commands_.empty())
+            throw std::logic_error("Commands cannot be combined with required or list arguments");
+        if (name.size() == 0)
             throw std::logic_error("Required argument must have a name");
     }
 
-    inline void Arguments::VerifyList(const std::string& name)
+    inline void Arguments::VerifyCommand(const Name& name)
     {
+        // Unlike the words of options, commands don't have segments
+        const char* const end = name.data() + name.size();
+        if (!required_.empty() || list_)
+            throw std::logic_error("Commands cannot be combined with required or list arguments");
+        if (name.size() == 0)
+            throw std::logic_error("Command must have a name");
+        if (std::find_if(name.data(), end, [](char ch){ return !std::isalnum((unsigned char)ch); }) != end)
+            throw std::logic_error("Command contains a non-alphanumeric character: " + std::string(name.data(), name.size()));
+    }
+
+    inline void Arguments::VerifyList(const Name& name)
+    {
+        if (!commands_.empty())
+            throw std::logic_error("Commands cannot be combined with required or list arguments");
         if (list_)
             throw std::logic_error("Only one list argument can be specified");
-        if (name.empty())
+        if (name.size() == 0)
             throw std::logic_error("List argument must have a name");
     }
 
-    inline bool Arguments::ProcessImpl(int argc, char* argv[], std::string& error) const
+    inline bool Arguments::ProcessImpl(detail::arglist& args, int argc, char* argv[], detail::ProcessState& state, std::string& error) const
     {
         error.clear();
+        detail::ScopedProcessState scopedState(state);
 
-        if (options_.empty() && required_.empty() && !list_)
+        // The paths are checked once the arguments have been processed, including a command's
+        if (!ProcessRange(args, args.cbegin(), args.cend(), argc, argv, error))
+            return false;
+        return state.paths.empty() || detail::CheckPaths(state.paths, error);
+    }
+
+    inline bool Arguments::ProcessRange(const detail::arglist& args, detail::arglist_iter first, detail::arglist_iter last, int argc, char* argv[], std::string& error) const
+    {
+        // Indexes (of unknown and passed through arguments) are into the whole command line, so a
+        // command's are indexes into the same argv
+        if (options_.empty() && required_.empty() && !list_ && !passthrough_ && commands_.empty() && !allowEmpty_)
             throw std::logic_error("No optional, required, or list arguments!");
 
-        stringlist args;
-        for (int index = 1; index < argc; ++index)
-            args.emplace_back(argv[index]);
+        // Everything after the first -- is passed through, or else is processed as required or
+        // list arguments (so values can't be taken from after it, and it can't be a value)
+        const detail::arglist_iter endOptions = std::find(first, last, "--");
+        const detail::arglist_iter lastArg = passthrough_ ? endOptions : last;
 
-        // Help or version?
+        // Help or version win wherever they are, even after an invalid argument, so they're found
+        // before anything is assigned (since assigning some values reads files or stdin)
 
-        if ((helpEnabled_ || !version_.empty()) && FindHelpOrVersion(args))
+        if ((helpEnabled_ || !version_.empty()) && FindHelpOrVersion(first, endOptions, error))
             return false;
 
+        if (passthrough_)
+            passthrough_->Assign(nullptr, 0, 0);
+        if (unknown_ != nullptr)
+            unknown_->clear();
+
         // Process optional and required arguments...
 
         auto nextRequired = required_.begin();
 
-        auto lastArg = args.cend();
-        for (auto currArg = args.cbegin(); currArg != lastArg; ++currArg)
+        detail::arglist_iter commandArg = last;
+        for (detail::arglist_iter currArg = first; currArg != lastArg && commandArg == last; ++currArg)
         {
-            if (currArg->empty())
+            if (currArg->empty() || currArg == endOptions)
                 continue;
 
+            const bool isOption = (currArg < endOptions);
+
             bool ok = false;
+            bool unknown = false;
+            std::string reason;
+            try
+            {
+                // A lone '-' isn't an option (it usually means stdin)
 #ifdef _MSC_VER
-            if (currArg->at(0) == '-' || currArg->at(0) == '/')
+                if (isOption && (currArg->at(0) == '-' || currArg->at(0) == '/') && currArg->size() > 1)
 #else
-            if (currArg->at(0) == '-')
+                if (isOption && currArg->at(0) == '-' && currArg->size() > 1)
 #endif
-                ok = ProcessOptions(currArg, lastArg);
-            else if (nextRequired != required_.end())
-                ok = ProcessRequired(currArg, lastArg, nextRequired);
-            else if (list_)
-                ok = ProcessList(currArg, lastArg);
+                    ok = ProcessOptions(currArg, endOptions, unknown);
+                else if (nextRequired != required_.end())
+                    ok = ProcessRequired(currArg, lastArg, nextRequired);
+                else if (list_)
+                    ok = ProcessList(currArg, lastArg);
+                else if (!commands_.empty())
+                {
+                    commandArg = currArg; //the following arguments are the command's
+                    ok = true;
+                }
+                else
+                    unknown = true;
+            }
+            catch (const detail::InvalidValue& ex)
+            {
+                reason = ex.what();
+            }
 
-            if (!ok)
+            if (!ok && unknown && unknown_ != nullptr)
+                unknown_->push_back((int)(currArg - args.cbegin()) + 1); //skipping the program name
+            else if (!ok)
             {
                 error = "Invalid argument: ";
                 error += *currArg;
+                if (!reason.empty())
+                {
+                    error += " (";
+                    error += reason;
+                    error += ')';
+                }
                 return false;
             }
         }
 
+        if (passthrough_ && endOptions != last)
+        {
+            // The arguments after -- aren't copied from argv (skipping the program name and --)
+            const auto index = (std::size_t)(endOptions - args.cbegin()) + 2;
+            if (argv != nullptr)
+                passthrough_->Assign(argv + index, index, (std::size_t)argc - index);
+            else
+                passthrough_->Assign(nullptr, index, args.size() + 1 - index);
+        }
+
         if (nextRequired != required_.end())
         {
             // One or more missing required arguments
             error = "Missing argument: ";
-            error += (*nextRequired)->getName();
+            error += (*nextRequired)->getName().str();
             return false;
         }
 
-        return true;
+        if (commands_.empty())
+            return true;
+        if (commandArg == last) //no argument was left for a command, such as when -- came first
+        {
+            error = "Missing command";
+            return false;
+        }
+        return ProcessCommand(args, commandArg, lastArg, argc, argv, error);
     }
 
-    inline bool Arguments::FindHelpOrVersion(const stringlist& args) const
+    inline bool Arguments::FindHelpOrVersion(detail::arglist_iter currArg, const detail::arglist_iter& lastArg, std::string& error) const
     {
-        for (auto& arg : args)
+        // Only arguments that are short options need to be compared, and a command's arguments are
+        // left to the command (which has help of its own)
+        for (; currArg != lastArg; ++currArg)
         {
-            if (helpEnabled_)
-            {
-                bool help = false;
+            if (!commands_.empty() && commandIndex_.count(detail::StringRef(currArg->c_str(), currArg->size())) != 0)
+                break;
+            if (ProcessHelpOrVersion(*currArg, error))
+                return true;
+        }
+        return false;
+    }
+
+    inline bool Arguments::ProcessHelpOrVersion(const std::string& arg, std::string& error) const
+    {
 #ifdef _MSC_VER
-                help = (strcompare(arg.c_str(), "/?") == 0) || (strcompare(arg.c_str(), "/help") == 0);
+        if (arg.empty() || (arg[0] != '-' && arg[0] != '/'))
+#else
+        if (arg.empty() || arg[0] != '-')
 #endif
-                if (!help)
-                    help = (strcompare(arg.c_str(), "-?") == 0) || (strcompare(arg.c_str(), "--help") == 0);
-                if (help)
-                {
-                    DisplayHelp();
-                    return true;
-                }
-            }
+            return false;
 
-            if (!version_.empty())
+        // Values taken by options haven't been folded, but help and version are short enough to
+        // fold a copy (that needn't be allocated); help can also be limited to the options under
+        // a prefix, such as --help=db.pool
+        const auto assign = arg.find('=');
+        if (std::min(assign, arg.size()) > std::strlen("--version"))
+            return false;
+        std::string word = arg.substr(0, assign);
+        if (ignoreCase_)
+            detail::FoldCase(&word[0], word.size());
+
+        if (helpEnabled_)
+        {
+            bool help = false;
+#ifdef _MSC_VER
+            help = (word == "/?") || (word == "/help");
+#endif
+            if (!help)
+                help = (word == "-?") || (word == "--help");
+            if (help)
             {
-                bool version = false;
+                // A prefix that no option is under is reported, rather than listing no options
+                const std::string prefix = (assign != std::string::npos) ? arg.substr(assign + 1) : std::string();
+                if (!prefix.empty() && GetOptionWords(prefix).empty())
+                    error = "Invalid argument: " + arg + " (unknown prefix)";
+                else if (detail::IsDataOnly())
+                    error = "Help requested";
+                else
+                    DisplayHelp(prefix);
+                return true;
+            }
+        }
+
+        if (assign != std::string::npos)
+            return false;
+
+        if (!version_.empty())
+        {
+            bool version = false;
 #ifdef _MSC_VER
-                version = (strcompare(arg.c_str(), "/?") == 0) || (strcompare(arg.c_str(), "/version") == 0);
+            version = (word == "/?") || (word == "/version");
 #endif
-                if (!version)
-                    version = (strcompare(arg.c_str(), "-?") == 0) || (strcompare(arg.c_str(), "--version") == 0);
-                if (version)
-                {
+            if (!version)
+                version = (word == "-?") || (word == "--version");
+            if (version)
+            {
+                if (detail::IsDataOnly())
+                    error = "Version requested";
+                else
                     DisplayVersion();
-                    return true;
-                }
+                return true;
             }
         }
 
         return false;
     }
 
-    inline void Arguments::DisplayHelp() const
+    inline void Arguments::DisplayHelp(std::string prefix) const
     {
+        if (!prefix.empty())
+        {
+            // Only the options under the prefix are listed
+            if (ignoreCase_)
+                detail::FoldCase(&prefix[0], prefix.size());
+            std::cout << "Options:\n";
+            for (const auto& entry : words_.Collect(detail::StringRef(prefix.c_str(), prefix.size())))
+                entry.option->OutputHelp();
+            std::cout << std::flush;
+            return;
+        }
+
         if (!header_.empty())
             std::cout << header_ << "\n\n";
 
@@ -256,15 +758,28 @@ namespace cyoarguments
             required->OutputUsage();
         if (list_)
             list_->OutputUsage();
+        if (passthrough_)
+            passthrough_->OutputUsage();
+        if (!commands_.empty())
+            commands_.front()->OutputUsage();
         std::cout << '\n';
 
-        if (!required_.empty() || list_)
+        if (!required_.empty() || list_ || passthrough_)
         {
             std::cout << '\n';
             for (const auto& required : required_)
                 required->OutputHelp();
             if (list_)
                 list_->OutputHelp();
+            if (passthrough_)
+                passthrough_->OutputHelp();
+        }
+
+        if (!commands_.empty())
+        {
+            std::cout << "\nCommands:\n";
+            for (const auto& command : commands_)
+                command->OutputHelp();
         }
 
         if (!options_.empty())
@@ -275,9 +790,9 @@ namespace cyoarguments
             if (numGroups_ >= 1)
                 std::cout << std::endl;
             if (helpEnabled_)
-                detail::OptionBase::OutputHelpImpl('?', "help", false, "display this help and exit", true);
+                detail::OptionBase::OutputHelpImpl('?', "help", nullptr, "display this help and exit", true);
             if (!version_.empty())
-                detail::OptionBase::OutputHelpImpl('\0', "version", false, "output version information and exit", true);
+                detail::OptionBase::OutputHelpImpl('\0', "version", nullptr, "output version information and exit", true);
         }
 
         if (!footer_.empty())
@@ -291,7 +806,7 @@ namespace cyoarguments
         std::cout << version_ << std::endl;
     }
 
-    inline bool Arguments::ProcessOptions(stringlist_iter& currArg, const stringlist_iter& lastArg) const
+    inline bool Arguments::ProcessOptions(detail::arglist_iter& currArg, const detail::arglist_iter& lastArg, bool& unknown) const
     {
         int ch = 0;
 
@@ -299,10 +814,10 @@ namespace cyoarguments
         if (currArg->at(ch) == '/')
         {
             ++ch;
-            if (ProcessWord(currArg, lastArg, ch))
+            if (ProcessWord(currArg, lastArg, ch, unknown))
                 return true;
             else
-                return ProcessLetters(currArg, lastArg, ch);
+                return ProcessLetters(currArg, lastArg, ch, unknown);
         }
 #endif
 
@@ -312,46 +827,110 @@ namespace cyoarguments
         if (currArg->at(ch) == '-')
         {
             ++ch;
-            return ProcessWord(currArg, lastArg, ch);
+            return ProcessWord(currArg, lastArg, ch, unknown);
         }
         else
-            return ProcessLetters(currArg, lastArg, ch);
+            return ProcessLetters(currArg, lastArg, ch, unknown);
     }
 
-    inline bool Arguments::ProcessWord(stringlist_iter& currArg, const stringlist_iter& lastArg, int& ch) const
+    inline bool Arguments::ProcessWord(detail::arglist_iter& currArg, const detail::arglist_iter& lastArg, int& ch, bool& unknown) const
     {
-        for (const auto& option : options_)
+        unknown = false;
+
+        // A word can also be followed directly by a number (such as --jobs5), so if the whole word
+        // isn't found, the words that the argument starts with are tried, longest first, but only
+        // where a number starts (and no longer than the longest word), so a long argument is only
+        // looked up a few times
+        const char* const word = currArg->c_str() + ch;
+        const char* const assignptr = std::strchr(word, '=');
+        const std::size_t len = (assignptr != nullptr) ? assignptr - word : std::strlen(word);
+
+        // When case is ignored, the word is looked up through a folded copy, so the argument (and
+        // so its value, and any error) is left as it was given
+        std::string folded;
+        const char* key = word;
+        if (ignoreCase_)
         {
-            bool error;
-            if (option->Process(currArg, lastArg, ch, true, error))
-                return true;
-            if (error)
-                return false;
+            folded.assign(word, len);
+            detail::FoldCase(&folded[0], folded.size());
+            key = folded.c_str();
         }
+
+        for (std::size_t wordLen = len; wordLen >= 1; )
+        {
+            const detail::WordTree::Entry* entry = words_.Find(detail::StringRef(key, wordLen));
+            if (entry != nullptr)
+            {
+                bool error;
+                if (entry->option->ProcessWord(currArg, lastArg, ch, wordLen, entry->negated, error))
+                    return true;
+                if (error || wordLen == len)
+                    return false;
+            }
+            wordLen = std::min(wordLen - 1, words_.maxSize());
+            while (wordLen >= 1 && !detail::StartsNumber(word + wordLen))
+                --wordLen;
+        }
+        unknown = true; //no option has this word
         return false;
     }
 
-    inline bool Arguments::ProcessLetters(stringlist_iter& currArg, const stringlist_iter& lastArg, int& ch) const
+    inline bool Arguments::ProcessFlagLetters(const std::string& arg, int ch) const
     {
-        stringlist_iter startArg = currArg;
+        // Only succeeds if every letter is a flag with the same target, which are then all set together
+        if (!flagLetters_)
+            return false;
+
+        std::uint64_t* flags = nullptr;
+        std::uint64_t mask = 0;
+        for (; ch < (int)arg.size(); ++ch)
+        {
+            const unsigned char letter = (unsigned char)arg[ch];
+            if (letter >= detail::numLetters)
+                return false;
+            const detail::FlagLetter& flagLetter = flagLetters_[letter];
+            if (flagLetter.flags == nullptr || (flags != nullptr && flagLetter.flags != flags))
+                return false;
+            flags = flagLetter.flags;
+            mask |= flagLetter.mask;
+        }
+        if (flags == nullptr)
+            return false;
+
+        *flags |= mask;
+        return true;
+    }
+
+    inline bool Arguments::ProcessLetters(detail::arglist_iter& currArg, const detail::arglist_iter& lastArg, int& ch, bool& unknown) const
+    {
+        // Letters are only unknown if the first one is, since the rest may then be its value
+        unknown = false;
+        const int firstCh = ch;
+
+        if (ProcessFlagLetters(*currArg, ch))
+        {
+            ch = (int)currArg->size();
+            return true;
+        }
+
+        detail::arglist_iter startArg = currArg;
         while ((startArg == currArg) && (ch < (int)currArg->size()))
         {
-            int chBak = ch;
-            for (const auto& option : options_)
+            const unsigned char letter = (unsigned char)currArg->at(ch);
+            const detail::OptionBase* option = (letter < detail::numLetters) ? letterIndex_[letter] : nullptr;
+            if (option == nullptr)
             {
-                bool error;
-                if (option->Process(currArg, lastArg, ch, false, error))
-                    break;
-                if (error)
-                    return false;
+                unknown = (ch == firstCh);
+                return false;
             }
-            if ((startArg == currArg) && (chBak == ch))
+            bool error;
+            if (!option->Process(currArg, lastArg, ch, false, error))
                 return false;
         }
         return (ch == (int)currArg->size()); //true if at end of current arg
     }
 
-    inline bool Arguments::ProcessRequired(stringlist_iter& currArg, const stringlist_iter& lastArg, detail::RequiredList::const_iterator& it) const
+    inline bool Arguments::ProcessRequired(detail::arglist_iter& currArg, const detail::arglist_iter& lastArg, detail::RequiredList::const_iterator& it) const
     {
         int ch = 0;
         bool error;
@@ -364,12 +943,42 @@ namespace cyoarguments
             return false;
     }
 
-    inline bool Arguments::ProcessList(stringlist_iter& currArg, const stringlist_iter& lastArg) const
+    inline bool Arguments::ProcessList(detail::arglist_iter& currArg, const detail::arglist_iter& lastArg) const
     {
         int ch = 0;
         bool error;
         return list_->Process(currArg, lastArg, ch, true, error);
     }
+
+    inline bool Arguments::ProcessCommand(const detail::arglist& args, detail::arglist_iter commandArg, detail::arglist_iter lastArg, int argc, char* argv[], std::string& error) const
+    {
+        auto it = commandIndex_.find(detail::StringRef(commandArg->c_str(), commandArg->size()));
+        if (it == commandIndex_.end())
+        {
+            error = "Invalid argument: " + *commandArg + " (unknown command)";
+            return false;
+        }
+        const detail::Command& command = *it->second;
+
+        Arguments arguments;
+        arguments.allowEmpty_ = true;
+        arguments.helpEnabled_ = helpEnabled_;
+        arguments.ignoreCase_ = ignoreCase_;
+        arguments.name_ = name_.empty() ? command.getName().str() : name_ + ' ' + command.getName().str();
+        arguments.version_ = version_;
+        arguments.header_ = command.getDescription();
+        command.Register(arguments);
+
+        // The command's arguments follow it, up to any -- that's passed through by these arguments;
+        // the command's unknown arguments are collected with these ones (unless it collects its own)
+        std::vector<int> unknown;
+        if (unknown_ != nullptr && arguments.unknown_ == nullptr)
+            arguments.unknown_ = &unknown;
+        const bool result = arguments.ProcessRange(args, std::next(commandArg), lastArg, argc, argv, error);
+        if (arguments.unknown_ == &unknown)
+            unknown_->insert(unknown_->end(), unknown.begin(), unknown.end());
+        return result;
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,188 @@
+/*
+[CyoArguments] detail/encoding.hpp
+
+The MIT License (MIT)
+
+Copyright (c) 2015-2016 Graham Bull
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __CYOARGUMENTS_ENCODING_HPP
+#define __CYOARGUMENTS_ENCODING_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cyoarguments
+{
+    namespace detail
+    {
+        // Decoding tables map each character to its value, or to 0xFF if it's invalid; the invalid
+        // values are ORed together and checked once at the end, so the loops have no branches
+
+        const std::uint8_t invalidDigit = 0xFF;
+
+        class DecodingTable final
+        {
+        public:
+            DecodingTable(const char* digits, bool ignoreCase)
+            {
+                std::fill(std::begin(values_), std::end(values_), invalidDigit);
+                for (std::uint8_t value = 0; digits[value] != '\0'; ++value)
+                {
+                    const unsigned char ch = (unsigned char)digits[value];
+                    values_[ch] = value;
+                    if (ignoreCase)
+                        values_[std::toupper(ch)] = value;
+                }
+            }
+
+            std::uint8_t operator[](char ch) const { return values_[(unsigned char)ch]; }
+
+        private:
+            std::uint8_t values_[256];
+        };
+
+        inline bool DecodeHex(const char* data, std::size_t size, std::vector<std::uint8_t>& bytes)
+        {
+            static const DecodingTable table("0123456789abcdef", true);
+
+            if (size % 2 != 0)
+                return false;
+            bytes.resize(size / 2);
+
+            std::uint8_t invalid = 0;
+            for (std::size_t index = 0; index < bytes.size(); ++index, data += 2)
+            {
+                const std::uint8_t high = table[data[0]];
+                const std::uint8_t low = table[data[1]];
+                invalid |= (high | low);
+                bytes[index] = (std::uint8_t)((high << 4) | (low & 0x0F));
+            }
+            return ((invalid & 0xF0) == 0);
+        }
+
+        inline bool DecodeBase64(const char* data, std::size_t size, std::vector<std::uint8_t>& bytes)
+        {
+            // Strict: padding is required, and the unused bits of the last character must be zero
+            static const DecodingTable table("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/", false);
+
+            if (size % 4 != 0)
+                return false;
+            std::size_t padding = 0;
+            if (size >= 4 && data[size - 1] == '=')
+                padding = (data[size - 2] == '=') ? 2 : 1;
+            bytes.resize((size / 4) * 3 - padding);
+
+            std::uint8_t invalid = 0;
+            const std::size_t fullQuads = (size / 4) - (padding != 0 ? 1 : 0);
+            std::uint8_t* out = bytes.data();
+            for (std::size_t quad = 0; quad < fullQuads; ++quad, data += 4, out += 3)
+            {
+                const std::uint8_t a = table[data[0]], b = table[data[1]], c = table[data[2]], d = table[data[3]];
+                invalid |= (a | b | c | d);
+                out[0] = (std::uint8_t)((a << 2) | ((b >> 4) & 0x03));
+                out[1] = (std::uint8_t)((b << 4) | ((c >> 2) & 0x0F));
+                out[2] = (std::uint8_t)((c << 6) | (d & 0x3F));
+            }
+
+            if (padding != 0)
+            {
+                const std::uint8_t a = table[data[0]], b = table[data[1]];
+                invalid |= (a | b);
+                out[0] = (std::uint8_t)((a << 2) | ((b >> 4) & 0x03));
+                if (padding == 1)
+                {
+                    const std::uint8_t c = table[data[2]];
+                    invalid |= c | (c & 0x03 ? invalidDigit : 0);
+                    out[1] = (std::uint8_t)((b << 4) | ((c >> 2) & 0x0F));
+                }
+                else
+                    invalid |= (b & 0x0F ? invalidDigit : 0);
+            }
+
+            return ((invalid & 0xC0) == 0);
+        }
+
+        inline bool IsValidUtf8(const char* data, std::size_t size)
+        {
+            // ASCII is checked 8 bytes at a time, and anything else is decoded one sequence at a time,
+            // rejecting overlong forms, surrogates, and code points above U+10FFFF
+            const unsigned char* ptr = (const unsigned char*)data;
+            const unsigned char* const endptr = ptr + size;
+            while (ptr != endptr)
+            {
+                std::uint64_t word;
+                if ((std::size_t)(endptr - ptr) >= sizeof(word))
+                {
+                    std::memcpy(&word, ptr, sizeof(word));
+                    if ((word & 0x8080808080808080ull) == 0)
+                    {
+                        ptr += sizeof(word);
+                        continue;
+                    }
+                }
+
+                const unsigned char lead = *ptr;
+                if (lead < 0x80)
+                {
+                    ++ptr;
+                    continue;
+                }
+
+                std::size_t length;
+                unsigned char min = 0x80, max = 0xBF; //limits of the second byte
+                if (0xC2 <= lead && lead <= 0xDF)
+                    length = 2;
+                else if (0xE0 <= lead && lead <= 0xEF)
+                {
+                    length = 3;
+                    if (lead == 0xE0)
+                        min = 0xA0;
+                    else if (lead == 0xED)
+                        max = 0x9F;
+                }
+                else if (0xF0 <= lead && lead <= 0xF4)
+                {
+                    length = 4;
+                    if (lead == 0xF0)
+                        min = 0x90;
+                    else if (lead == 0xF4)
+                        max = 0x8F;
+                }
+                else
+                    return false;
+
+                if ((std::size_t)(endptr - ptr) < length || ptr[1] < min || ptr[1] > max)
+                    return false;
+                for (std::size_t index = 2; index < length; ++index)
+                {
+                    if ((ptr[index] & 0xC0) != 0x80)
+                        return false;
+                }
+                ptr += length;
+            }
+            return true;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif //__CYOARGUMENTS_ENCODING_HPP
@@ -0,0 +1,310 @@
+/*
+[CyoArguments] detail/expand.hpp
+
+The MIT License (MIT)
+
+Copyright (c) 2015-2016 Graham Bull
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __CYOARGUMENTS_EXPAND_HPP
+#define __CYOARGUMENTS_EXPAND_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cyoarguments
+{
+    namespace detail
+    {
+        // Expansion of list values that are glob patterns or directories, for programs that
+        // aren't started by a shell (on Windows, the values are always used as they are)
+
+#ifndef _WIN32
+        inline std::string JoinPath(const std::string& dir, const char* name)
+        {
+            if (dir.empty())
+                return name;
+            if (dir.back() == '/')
+                return dir + name;
+            return dir + '/' + name;
+        }
+
+        inline bool IsDirectory(const std::string& path)
+        {
+            struct stat st;
+            return (::stat(path.c_str(), &st) == 0) && S_ISDIR(st.st_mode);
+        }
+
+        // Calls func(name, isDirectory, isLink) for each entry of a directory, which readdir reads
+        // in batches (using getdents64 on Linux); the file type is taken from the entry if possible
+        template<typename Func>
+        void ForEachEntry(const std::string& dir, Func func)
+        {
+            // The handle is closed even if func throws (such as when directories are nested too deeply)
+            std::unique_ptr<DIR, int (*)(DIR*)> handle(::opendir(dir.empty() ? "." : dir.c_str()), &::closedir);
+            if (!handle)
+                return;
+            while (const struct dirent* entry = ::readdir(handle.get()))
+            {
+                const char* name = entry->d_name;
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                    continue;
+
+                bool isDirectory = false, isLink = false;
+#ifdef _DIRENT_HAVE_D_TYPE
+                if (entry->d_type != DT_UNKNOWN)
+                {
+                    isDirectory = (entry->d_type == DT_DIR);
+                    isLink = (entry->d_type == DT_LNK);
+                }
+                else
+#endif
+                {
+                    struct stat st;
+                    if (::lstat(JoinPath(dir, name).c_str(), &st) == 0)
+                    {
+                        isDirectory = S_ISDIR(st.st_mode);
+                        isLink = S_ISLNK(st.st_mode);
+                    }
+                }
+                func(name, isDirectory, isLink);
+            }
+        }
+
+        // Adds everything below a directory, without following links to other directories (a link
+        // is added as it is); the depth is limited too, since a bind mount can still make a loop
+        const int maxDirectoryDepth = 64;
+
+        inline void FindFiles(const std::string& dir, std::vector<std::string>& paths, int depth = 0)
+        {
+            if (depth == maxDirectoryDepth)
+                throw InvalidValue("directories nested too deeply: " + dir);
+            ForEachEntry(dir, [&](const char* name, bool isDirectory, bool isLink)
+            {
+                UNREFERENCED_PARAMETER(isLink);
+                if (isDirectory)
+                    FindFiles(JoinPath(dir, name), paths, depth + 1);
+                else
+                    paths.push_back(JoinPath(dir, name));
+            });
+        }
+
+        inline bool HasWildcard(const std::string& value)
+        {
+            return (value.find_first_of("*?[") != std::string::npos);
+        }
+
+        // Each component of the pattern is matched against the entries of the directories that
+        // matched the previous components (wildcards don't match a leading '.')
+        inline void FindMatches(const std::string& pattern, std::vector<std::string>& matches)
+        {
+            std::vector<std::string> dirs{ (pattern[0] == '/') ? "/" : "" };
+            std::vector<std::string> nextDirs;
+            bool checkExists = false;
+
+            for (std::size_t start = 0; start < pattern.size(); )
+            {
+                std::size_t end = pattern.find('/', start);
+                if (end == std::string::npos)
+                    end = pattern.size();
+                const std::string component = pattern.substr(start, end - start);
+                const bool last = (end == pattern.size());
+                start = end + 1;
+                if (component.empty())
+                    continue;
+
+                nextDirs.clear();
+                if (!HasWildcard(component))
+                {
+                    for (const auto& dir : dirs)
+                        nextDirs.push_back(JoinPath(dir, component.c_str()));
+                    checkExists = true;
+                }
+                else
+                {
+                    for (const auto& dir : dirs)
+                    {
+                        ForEachEntry(dir, [&](const char* name, bool isDirectory, bool isLink)
+                        {
+                            if (::fnmatch(component.c_str(), name, FNM_PERIOD) != 0)
+                                return;
+                            std::string path = JoinPath(dir, name);
+                            if (last || isDirectory || (isLink && IsDirectory(path)))
+                                nextDirs.push_back(std::move(path));
+                        });
+                    }
+                    checkExists = false;
+                }
+                dirs.swap(nextDirs);
+            }
+
+            for (auto& path : dirs)
+            {
+                struct stat st;
+                if (!checkExists || ::lstat(path.c_str(), &st) == 0)
+                    matches.push_back(std::move(path));
+            }
+        }
+#endif
+
+        inline void ExpandPath(const std::string& arg, unsigned expand, std::vector<std::string>& paths)
+        {
+#ifndef _WIN32
+            const bool expandGlob = ((expand & ExpandGlob) != 0) && HasWildcard(arg);
+            const bool expandDirectory = ((expand & ExpandDirectory) != 0);
+
+            const std::size_t first = paths.size();
+            if (expandGlob)
+            {
+                std::vector<std::string> matches;
+                FindMatches(arg, matches);
+                if (matches.empty())
+                    throw InvalidValue("no matches");
+                for (auto& match : matches)
+                {
+                    if (expandDirectory && IsDirectory(match))
+                        FindFiles(match, paths);
+                    else
+                        paths.push_back(std::move(match));
+                }
+            }
+            else if (expandDirectory && IsDirectory(arg))
+                FindFiles(arg, paths);
+            else
+                paths.push_back(arg);
+
+            if (expand & ExpandSorted)
+                std::sort(paths.begin() + first, paths.end());
+#else
+            UNREFERENCED_PARAMETER(expand);
+            paths.push_back(arg);
+#endif
+        }
+
+        // Values read from stdin are added to the target as they're found, so only the value
+        // that's being read (which is usually shorter than the buffer) is held in memory
+
+#ifdef _WIN32
+        const int stdinHandle = 0;
+#else
+        const int stdinHandle = STDIN_FILENO;
+#endif
+        const std::size_t readBufferSize = 64 * 1024;
+
+        template<typename T>
+        void AddReadValue(const std::string& value, T& target, std::true_type)
+        {
+            // Strings and paths are used as they are (as when expanding globs)
+            target.emplace_back(value);
+            RecordPathValue(target.back());
+        }
+
+        template<typename T>
+        void AddReadValue(const std::string& value, T& target, std::false_type)
+        {
+            if (GetValue(value, target) != (int)value.size())
+                throw InvalidValue("invalid value: " + value);
+        }
+
+        template<typename T>
+        void ReadValues(int fd, char delimiter, T& target)
+        {
+            std::vector<char> buffer(readBufferSize);
+            std::size_t used = 0; //a partial value, moved to the start of the buffer
+            std::string value; //reused for every value
+
+            auto addValue = [&](const char* startptr, const char* endptr)
+            {
+                if (delimiter == '\n' && endptr != startptr && endptr[-1] == '\r')
+                    --endptr;
+                if (endptr == startptr)
+                    return;
+                value.assign(startptr, endptr);
+                AddReadValue(value, target, allow_list_expansion<T>());
+            };
+
+            for (;;)
+            {
+                if (used == buffer.size())
+                    buffer.resize(buffer.size() * 2); //a value that's longer than the buffer
+#ifdef _WIN32
+                const int len = ::_read(fd, buffer.data() + used, (unsigned int)(buffer.size() - used));
+#else
+                const ssize_t len = ::read(fd, buffer.data() + used, buffer.size() - used);
+                if (len < 0 && errno == EINTR)
+                    continue;
+#endif
+                if (len < 0)
+                    throw InvalidValue(std::string("cannot read stdin: ") + std::strerror(errno));
+
+                const char* ptr = buffer.data();
+                const char* const endptr = ptr + used + len;
+                if (len == 0)
+                {
+                    addValue(ptr, endptr);
+                    break;
+                }
+
+                // Only the new data can contain a delimiter
+                const char* searchptr = ptr + used;
+                while (auto nextptr = (const char*)std::memchr(searchptr, delimiter, endptr - searchptr))
+                {
+                    addValue(ptr, nextptr);
+                    ptr = searchptr = nextptr + 1;
+                }
+                used = (std::size_t)(endptr - ptr);
+                std::memmove(buffer.data(), ptr, used);
+            }
+        }
+
+        template<typename Container>
+        int GetExpandedValues(const std::string& arg, Container& target, unsigned expand, std::true_type)
+        {
+            std::vector<std::string> paths;
+            ExpandPath(arg, expand, paths);
+
+            // The paths are used as they are, rather than parsed as values
+            ReserveValues(target, paths.size());
+            for (auto& path : paths)
+            {
+                target.emplace_back(std::move(path));
+                RecordPathValue(target.back());
+            }
+            return (int)arg.size();
+        }
+
+        template<typename T>
+        int GetExpandedValues(const std::string& arg, T& target, unsigned expand, std::false_type)
+        {
+            UNREFERENCED_PARAMETER(expand);
+            return GetValue(arg, target);
+        }
+
+        template<typename T>
+        int GetExpandedValues(const std::string& arg, T& target, unsigned expand)
+        {
+            return GetExpandedValues(arg, target, expand, allow_list_expansion<T>());
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif //__CYOARGUMENTS_EXPAND_HPP
@@ -0,0 +1,125 @@
+/*
+[CyoArguments] detail/file.hpp
+
+The MIT License (MIT)
+
+Copyright (c) 2015-2016 Graham Bull
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __CYOARGUMENTS_FILE_HPP
+#define __CYOARGUMENTS_FILE_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cyoarguments
+{
+    namespace detail
+    {
+        // The contents of a file, memory-mapped where possible (otherwise read into a buffer)
+        class MappedFile final
+        {
+        public:
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator =(const MappedFile&) = delete;
+
+            explicit MappedFile(const std::string& path)
+            {
+#ifdef _WIN32
+                std::ifstream file(path, std::ios::in | std::ios::binary);
+                if (!file)
+                    throw InvalidValue(path + ": cannot open file");
+                buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+                if (file.bad())
+                    throw InvalidValue(path + ": cannot read file");
+                data_ = buffer_.data();
+                size_ = buffer_.size();
+#else
+                int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0)
+                    throw InvalidValue(path + ": " + std::strerror(errno));
+
+                struct stat st;
+                if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+                {
+                    void* addr = ::mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (addr != MAP_FAILED)
+                    {
+                        ::close(fd);
+                        data_ = (const char*)addr;
+                        size_ = (std::size_t)st.st_size;
+                        mapped_ = true;
+                        return;
+                    }
+                }
+
+                // Not a regular file (such as a pipe), or it can't be mapped
+                char chunk[65536];
+                for (;;)
+                {
+                    auto len = ::read(fd, chunk, sizeof(chunk));
+                    if (len == 0)
+                        break;
+                    if (len < 0)
+                    {
+                        if (errno == EINTR)
+                            continue;
+                        int err = errno;
+                        ::close(fd);
+                        throw InvalidValue(path + ": " + std::strerror(err));
+                    }
+                    buffer_.append(chunk, (std::size_t)len);
+                }
+                ::close(fd);
+                data_ = buffer_.data();
+                size_ = buffer_.size();
+#endif
+            }
+
+            ~MappedFile()
+            {
+#ifndef _WIN32
+                if (mapped_)
+                    ::munmap((void*)data_, size_);
+#endif
+            }
+
+            const char* data() const { return data_; }
+            std::size_t size() const { return size_; }
+
+        private:
+            const char* data_ = "";
+            std::size_t size_ = 0;
+            bool mapped_ = false;
+            std::string buffer_;
+        };
+
+        // Values of @path given to a Content, HexBytes or Base64Bytes are replaced by the contents
+        // of the file (unless the command line is only data), and @@ is a literal @
+        inline bool IsFileValue(const char* value)
+        {
+            return (value[0] == '@' && value[1] != '\0' && value[1] != '@') && !IsDataOnly();
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif //__CYOARGUMENTS_FILE_HPP
@@ -34,7 +34,7 @@ namespace cyoarguments
     namespace detail
     {
         template<typename T>
-        int GetValue(const std::string& arg, T& target)
+        int GetEnum(const std::string& arg, T& target, std::false_type)
         {
             UNREFERENCED_PARAMETER(arg);
             UNREFERENCED_PARAMETER(target);
@@ -45,8 +45,17 @@ namespace cyoarguments
 #endif
         }
 
+        template<typename T>
+        int GetEnum(const std::string& arg, T& target, std::true_type);
+
+        template<typename T>
+        int GetValue(const std::string& arg, T& target)
+        {
+            return GetEnum(arg, target, std::is_enum<T>());
+        }
+
         template<>
-        int GetValue(const std::string& arg, bool& target)
+        inline int GetValue(const std::string& arg, bool& target)
         {
             UNREFERENCED_PARAMETER(arg);
             target = true;
@@ -54,25 +63,144 @@ namespace cyoarguments
         }
 
         template<>
-        int GetValue(const std::string& arg, int& target)
+        inline int GetValue(const std::string& arg, Counter& target)
         {
-            const char* startptr = arg.c_str();
-            char* endptr = nullptr;
-            target = (int)std::strtol(startptr, &endptr, 0);
-            return (int)(endptr - startptr);
+            UNREFERENCED_PARAMETER(arg);
+            target.increment();
+            return 0;
+        }
+
+        // integers
+
+        inline unsigned int GetDigit(char ch)
+        {
+            // Digits and letters map to 0-35, anything else is out of range for every base
+            if ('0' <= ch && ch <= '9')
+                return (unsigned int)(ch - '0');
+            ch |= (1 << 5); //make lowercase
+            if ('a' <= ch && ch <= 'z')
+                return (unsigned int)(ch - 'a' + 10);
+            return 36;
+        }
+
+        template<typename T>
+        int GetInteger(const std::string& arg, T& target)
+        {
+            // Accepts the same syntax as strtol with base 0 (decimal, 0x hex, 0 octal), but
+            // rejects values that are out of range of T instead of truncating them
+            using ulonglong = unsigned long long;
+
+            const char* const startptr = arg.c_str();
+            const char* ptr = startptr;
+            while (std::isspace((unsigned char)*ptr))
+                ++ptr;
+
+            const bool negative = (*ptr == '-');
+            if (*ptr == '-' || *ptr == '+')
+                ++ptr;
+
+            unsigned int base = 10;
+            if (ptr[0] == '0')
+            {
+                if ((ptr[1] == 'x' || ptr[1] == 'X') && GetDigit(ptr[2]) < 16)
+                {
+                    base = 16;
+                    ptr += 2;
+                }
+                else
+                    base = 8;
+            }
+
+            const char* const digitsptr = ptr;
+            const ulonglong maxValue = std::numeric_limits<ulonglong>::max();
+            ulonglong value = 0;
+            bool overflow = false;
+            for (unsigned int digit = GetDigit(*ptr); digit < base; digit = GetDigit(*++ptr))
+            {
+                overflow |= (value > (maxValue - digit) / base);
+                value = (value * base) + digit;
+            }
+            if (ptr == digitsptr || overflow)
+                return 0;
+
+            // The magnitude of the most negative value is one more than the maximum
+            const ulonglong limit = negative
+                ? (std::is_signed<T>::value ? (ulonglong)std::numeric_limits<T>::max() + 1 : 0)
+                : (ulonglong)std::numeric_limits<T>::max();
+            if (value > limit)
+                return 0;
+
+            if (negative && value != 0)
+                target = (T)(-(long long)(value - 1) - 1);
+            else
+                target = (T)value;
+            return (int)(ptr - startptr);
         }
 
         template<>
-        int GetValue(const std::string& arg, unsigned int& target)
+        inline int GetValue(const std::string& arg, signed char& target)
         {
-            const char* startptr = arg.c_str();
-            char* endptr = nullptr;
-            target = (unsigned int)std::strtoul(startptr, &endptr, 0);
-            return (int)(endptr - startptr);
+            return GetInteger(arg, target);
+        }
+
+        template<>
+        inline int GetValue(const std::string& arg, unsigned char& target)
+        {
+            return GetInteger(arg, target);
+        }
+
+        template<>
+        inline int GetValue(const std::string& arg, short& target)
+        {
+            return GetInteger(arg, target);
+        }
+
+        template<>
+        inline int GetValue(const std::string& arg, unsigned short& target)
+        {
+            return GetInteger(arg, target);
+        }
+
+        template<>
+        inline int GetValue(const std::string& arg, int& target)
+        {
+            return GetInteger(arg, target);
+        }
+
+        template<>
+        inline int GetValue(const std::string& arg, unsigned int& target)
+        {
+            return GetInteger(arg, target);
+        }
+
+        template<>
+        inline int GetValue(const std::string& arg, long& target)
+        {
+            return GetInteger(arg, target);
+        }
+
+        template<>
+        inline int GetValue(const std::string& arg, unsigned long& target)
+        {
+            return GetInteger(arg, target);
         }
 
         template<>
-        int GetValue(const std::string& arg, float& target)
+        inline int GetValue(const std::string& arg, long long& target)
+        {
+            return GetInteger(arg, target);
+        }
+
+        template<>
+        inline int GetValue(const std::string& arg, unsigned long long& target)
+        {
+            return GetInteger(arg, target);
+        }
+
+        // floating point
+
+        template<>
+        inline int GetValue(const std::string& arg, float& target)
         {
             const char* startptr = arg.c_str();
             char* endptr = nullptr;
@@ -81,7 +209,7 @@ namespace cyoarguments
         }
 
         template<>
-        int GetValue(const std::string& arg, double& target)
+        inline int GetValue(const std::string& arg, double& target)
         {
             const char* startptr = arg.c_str();
             char* endptr = nullptr;
@@ -90,7 +218,7 @@ namespace cyoarguments
         }
 
         template<>
-        int GetValue(const std::string& arg, std::string& target)
+        inline int GetValue(const std::string& arg, std::string& target)
         {
             if (!arg.empty() && arg[0] == '=')
             {
@@ -104,6 +232,331 @@ namespace cyoarguments
             }
         }
 
+        template<>
+        inline int GetValue(const std::string& arg, Content& target)
+        {
+            // Only a Content (or binary data) reads @path, so that strings are always used as they
+            // are; the contents of the file are used without copying them
+            const std::size_t start = (!arg.empty() && arg[0] == '=') ? 1 : 0;
+            if (IsFileValue(arg.c_str() + start))
+            {
+                auto file = std::make_shared<const MappedFile>(arg.substr(start + 1));
+                target = Content(file, file->data(), file->size());
+            }
+            else
+            {
+                auto value = std::make_shared<const std::string>(arg.substr(arg.compare(start, 2, "@@") == 0 ? start + 1 : start));
+                target = Content(value, value->data(), value->size());
+            }
+            return (int)arg.size();
+        }
+
+        template<>
+        inline int GetValue(const std::string& arg, Utf8String& target)
+        {
+            std::string value;
+            const int len = GetValue(arg, value);
+            if (!IsValidUtf8(value.data(), value.size()))
+                throw InvalidValue("invalid UTF-8");
+            target.value_ = std::move(value);
+            return len;
+        }
+
+        template<unsigned Checks>
+        int GetValue(const std::string& arg, Path<Checks>& target)
+        {
+            const std::size_t start = (!arg.empty() && arg[0] == '=') ? 1 : 0;
+            target = Path<Checks>(arg.substr(start));
+            RecordPathValue(target);
+            return (int)arg.size();
+        }
+
+        // binary data
+
+        template<typename Bytes>
+        int GetBytes(const std::string& arg, Bytes& target, bool (*decode)(const char*, std::size_t, std::vector<std::uint8_t>&), const char* encoding)
+        {
+            const std::size_t start = (!arg.empty() && arg[0] == '=') ? 1 : 0;
+            if (arg.size() == start)
+                return 0;
+
+            std::vector<std::uint8_t> bytes;
+            bool valid;
+            if (IsFileValue(arg.c_str() + start))
+            {
+                // Trailing whitespace, such as the final newline, is ignored in files
+                MappedFile file(arg.substr(start + 1));
+                std::size_t size = file.size();
+                while (size != 0 && std::isspace((unsigned char)file.data()[size - 1]))
+                    --size;
+                valid = decode(file.data(), size, bytes);
+            }
+            else
+                valid = decode(arg.c_str() + start, arg.size() - start, bytes);
+
+            if (!valid)
+                throw InvalidValue(std::string("invalid ") + encoding);
+            target = Bytes(std::move(bytes));
+            return (int)arg.size();
+        }
+
+        template<>
+        inline int GetValue(const std::string& arg, HexBytes& target)
+        {
+            return GetBytes(arg, target, DecodeHex, "hex");
+        }
+
+        template<>
+        inline int GetValue(const std::string& arg, Base64Bytes& target)
+        {
+            return GetBytes(arg, target, DecodeBase64, "base64");
+        }
+
+        // sizes and durations
+
+        inline int GetDecimal(const char* startptr, unsigned long long& value)
+        {
+            const unsigned long long maxValue = std::numeric_limits<unsigned long long>::max();
+            const char* ptr = startptr;
+            bool overflow = false;
+            value = 0;
+            for (; '0' <= *ptr && *ptr <= '9'; ++ptr)
+            {
+                const unsigned int digit = (unsigned int)(*ptr - '0');
+                overflow |= (value > (maxValue - digit) / 10);
+                value = (value * 10) + digit;
+            }
+            return overflow ? 0 : (int)(ptr - startptr);
+        }
+
+        template<>
+        inline int GetValue(const std::string& arg, ByteSize& target)
+        {
+            // K, M, G, T, P and E are powers of 1024 (as are KiB, MiB, etc.), whereas KB, MB, etc. are powers of 1000
+            const char* const startptr = arg.c_str();
+            unsigned long long value;
+            const char* ptr = startptr + GetDecimal(startptr, value);
+            if (ptr == startptr)
+                return 0;
+
+            const char* const units = "KMGTPE";
+            const char* unit = (*ptr != '\0') ? std::strchr(units, std::toupper((unsigned char)*ptr)) : nullptr;
+            unsigned long long multiplier = 1;
+            if (unit != nullptr)
+            {
+                unsigned long long base = 1024;
+                if (ptr[1] == 'i' && ptr[2] == 'B')
+                    ptr += 3;
+                else if (ptr[1] == 'B')
+                {
+                    base = 1000;
+                    ptr += 2;
+                }
+                else
+                    ++ptr;
+                for (auto power = unit - units; power >= 0; --power)
+                    multiplier *= base;
+            }
+            else if (*ptr == 'B')
+                ++ptr;
+
+            if (value > std::numeric_limits<unsigned long long>::max() / multiplier)
+                return 0;
+
+            target = ByteSize(value * multiplier);
+            return (int)(ptr - startptr);
+        }
+
+        template<typename Unit, typename Rep, typename Period>
+        bool GetDuration(unsigned long long value, std::chrono::duration<Rep, Period>& target)
+        {
+            // Only accept values that convert exactly into the target's units
+            using ratio = std::ratio_divide<Unit, Period>;
+            if (value > std::numeric_limits<unsigned long long>::max() / ratio::num)
+                return false;
+            const unsigned long long count = value * ratio::num;
+            if (!std::is_floating_point<Rep>::value
+                && ((count % ratio::den) != 0 || (count / ratio::den) > (unsigned long long)std::numeric_limits<Rep>::max()))
+                return false;
+            target = std::chrono::duration<Rep, Period>((Rep)count / (Rep)ratio::den);
+            return true;
+        }
+
+        template<typename Rep, typename Period>
+        int GetValue(const std::string& arg, std::chrono::duration<Rep, Period>& target)
+        {
+            // Units are ns, us, ms, s, m and h; a value without units is in the target's own units
+            const char* const startptr = arg.c_str();
+            unsigned long long value;
+            const char* ptr = startptr + GetDecimal(startptr, value);
+            if (ptr == startptr)
+                return 0;
+
+            bool ok;
+            if (ptr[0] == 'n' && ptr[1] == 's')
+            {
+                ok = GetDuration<std::nano>(value, target);
+                ptr += 2;
+            }
+            else if (ptr[0] == 'u' && ptr[1] == 's')
+            {
+                ok = GetDuration<std::micro>(value, target);
+                ptr += 2;
+            }
+            else if (ptr[0] == 'm' && ptr[1] == 's')
+            {
+                ok = GetDuration<std::milli>(value, target);
+                ptr += 2;
+            }
+            else if (ptr[0] == 's')
+            {
+                ok = GetDuration<std::ratio<1>>(value, target);
+                ++ptr;
+            }
+            else if (ptr[0] == 'm')
+            {
+                ok = GetDuration<std::ratio<60>>(value, target);
+                ++ptr;
+            }
+            else if (ptr[0] == 'h')
+            {
+                ok = GetDuration<std::ratio<3600>>(value, target);
+                ++ptr;
+            }
+            else
+                ok = GetDuration<Period>(value, target);
+
+            return ok ? (int)(ptr - startptr) : 0;
+        }
+
+        // index sets
+
+        template<>
+        inline int GetValue(const std::string& arg, IndexSet& target)
+        {
+            // Comma-separated indexes or ranges of indexes, each range having an optional stride
+            const char* const startptr = arg.c_str();
+            const char* ptr = startptr;
+            for (;;)
+            {
+                unsigned long long first, last, stride = 1;
+                const char* endptr = ptr + GetDecimal(ptr, first);
+                if (endptr == ptr)
+                    break;
+                last = first;
+                if (*endptr == '-')
+                {
+                    const char* lastptr = endptr + 1;
+                    endptr = lastptr + GetDecimal(lastptr, last);
+                    if (endptr == lastptr)
+                        break;
+                    if (*endptr == ':')
+                    {
+                        const char* strideptr = endptr + 1;
+                        endptr = strideptr + GetDecimal(strideptr, stride);
+                        if (endptr == strideptr)
+                            break;
+                    }
+                }
+                if (last < first || last > IndexSet::maxIndex || stride == 0)
+                    break;
+
+                target.set((std::size_t)first, (std::size_t)last, (std::size_t)stride);
+
+                ptr = endptr;
+                if (*ptr != ',')
+                    return (int)(ptr - startptr);
+                ++ptr;
+            }
+            return (ptr == startptr) ? 0 : (int)(ptr - startptr - 1); //exclude the delimiter
+        }
+
+        // enums
+
+        template<typename E>
+        class EnumIndex final
+        {
+        public:
+            EnumIndex(const EnumIndex&) = delete;
+            EnumIndex& operator =(const EnumIndex&) = delete;
+
+            static const EnumIndex& instance()
+            {
+                static const EnumIndex index;
+                return index;
+            }
+
+            const EnumName<E>* find(const char* name, std::size_t len) const
+            {
+                if (len == 0)
+                    return nullptr;
+                for (auto slot = Hash(name, len); slots_[slot] != 0; slot = (slot + 1) & mask_)
+                {
+                    const EnumName<E>& entry = names_.begin()[slots_[slot] - 1];
+                    if (std::strncmp(entry.name, name, len) == 0 && entry.name[len] == '\0')
+                        return &entry;
+                }
+                return nullptr;
+            }
+
+            const char* choices() const { return choices_.c_str(); }
+
+        private:
+            const EnumNames<E> names_;
+            std::vector<std::size_t> slots_; //index + 1 of each name, or 0 if empty
+            std::size_t mask_;
+            std::string choices_;
+
+            EnumIndex()
+                : names_(enum_names<E>::get())
+            {
+                // Open addressing, with the hash of each name based on its length and its first
+                // and last characters; names normally have their own slots, so one comparison is enough
+                std::size_t size = 1;
+                while (size < 2 * names_.size())
+                    size <<= 1;
+                slots_.assign(size, 0);
+                mask_ = size - 1;
+
+                for (std::size_t index = 0; index < names_.size(); ++index)
+                {
+                    const char* name = names_.begin()[index].name;
+                    const std::size_t len = std::strlen(name);
+                    if (len == 0)
+                        throw std::logic_error("Enum name cannot be blank");
+                    if (find(name, len) != nullptr)
+                        throw std::logic_error(std::string("Duplicate enum name: ") + name);
+
+                    auto slot = Hash(name, len);
+                    while (slots_[slot] != 0)
+                        slot = (slot + 1) & mask_;
+                    slots_[slot] = index + 1;
+
+                    if (!choices_.empty())
+                        choices_ += '|';
+                    choices_ += name;
+                }
+            }
+
+            std::size_t Hash(const char* name, std::size_t len) const
+            {
+                return ((len * 31) ^ ((unsigned char)name[0] * 7) ^ (unsigned char)name[len - 1]) & mask_;
+            }
+        };
+
+        template<typename T>
+        int GetEnum(const std::string& arg, T& target, std::true_type)
+        {
+            if (arg.empty())
+                return 0;
+            const EnumIndex<T>& index = EnumIndex<T>::instance();
+            const EnumName<T>* entry = index.find(arg.c_str(), arg.size());
+            if (entry == nullptr)
+                throw InvalidValue(std::string("expected ") + index.choices());
+            target = entry->value;
+            return (int)arg.size();
+        }
+
         // nullable
 
         template<typename T>
@@ -122,7 +575,8 @@ namespace cyoarguments
         {
             T value;
             int len = GetValue(arg, value);
-            target.push_back(value);
+            if (len == (int)arg.size())
+                target.push_back(std::move(value));
             return len;
         }
 
@@ -131,9 +585,179 @@ namespace cyoarguments
         {
             T value;
             int len = GetValue(arg, value);
-            target.push_back(value);
+            if (len == (int)arg.size())
+                target.push_back(std::move(value));
             return len;
         }
+
+        // maps (for example, -Dname=value)
+
+        template<typename T>
+        int GetMapValue(const char* startptr, const char* endptr, T& target)
+        {
+            return GetValue(std::string(startptr, endptr), target);
+        }
+
+        inline int GetMapValue(const char* startptr, const char* endptr, std::string& target)
+        {
+            target.assign(startptr, endptr);
+            return (int)target.size();
+        }
+
+        template<typename Map>
+        int GetMapValues(const std::string& arg, Map& target)
+        {
+            // The key is everything before the first '=', and the value everything after it
+            const char* const startptr = arg.c_str();
+            const char* const endptr = startptr + arg.size();
+            auto assignptr = (const char*)std::memchr(startptr, '=', arg.size());
+            if (assignptr == nullptr || assignptr == startptr)
+                return 0;
+
+            typename Map::key_type key;
+            if (GetMapValue(startptr, assignptr, key) != (int)(assignptr - startptr))
+                return 0;
+            typename Map::mapped_type value;
+            if (GetMapValue(assignptr + 1, endptr, value) != (int)(endptr - assignptr - 1))
+                return 0;
+
+            target[std::move(key)] = std::move(value);
+            return (int)arg.size();
+        }
+
+        template<typename K, typename V>
+        int GetValue(const std::string& arg, std::map<K, V>& target)
+        {
+            return GetMapValues(arg, target);
+        }
+
+        template<typename K, typename V>
+        int GetValue(const std::string& arg, std::unordered_map<K, V>& target)
+        {
+            return GetMapValues(arg, target);
+        }
+
+        // delimited values (for example, --ids=1,2,3)
+
+        template<typename T>
+        void ReserveValues(std::vector<T>& target, std::size_t count)
+        {
+            target.reserve(target.size() + count);
+        }
+
+        template<typename T>
+        void ReserveValues(std::list<T>& target, std::size_t count)
+        {
+            UNREFERENCED_PARAMETER(target);
+            UNREFERENCED_PARAMETER(count);
+        }
+
+        template<typename Container>
+        int GetDelimitedValues(const std::string& arg, Container& target, char delimiter)
+        {
+            // Returns the length of the valid values, which is less than the length of the argument
+            // if any value is invalid (as with a single value)
+            const char* const startptr = arg.c_str();
+            const char* const endptr = startptr + arg.size();
+            ReserveValues(target, 1 + std::count(arg.begin(), arg.end(), delimiter));
+
+            std::string element; //reused for every value
+            for (const char* ptr = startptr; ; )
+            {
+                auto nextptr = (const char*)std::memchr(ptr, delimiter, endptr - ptr);
+                if (nextptr == nullptr)
+                    nextptr = endptr;
+                element.assign(ptr, nextptr);
+
+                typename Container::value_type value;
+                int len = GetValue(element, value);
+                if (len < 1)
+                    return (ptr == startptr) ? 0 : (int)(ptr - startptr - 1); //exclude the delimiter
+                target.push_back(std::move(value));
+                if (len != (int)element.size())
+                    return (int)(ptr - startptr) + len;
+
+                if (nextptr == endptr)
+                    return (int)arg.size();
+                ptr = nextptr + 1;
+            }
+        }
+
+        template<typename T>
+        int GetValues(const std::string& arg, T& target, char delimiter)
+        {
+            UNREFERENCED_PARAMETER(delimiter);
+            return GetValue(arg, target);
+        }
+
+        template<typename T>
+        int GetValues(const std::string& arg, std::list<T>& target, char delimiter)
+        {
+            if (delimiter == '\0')
+                return GetValue(arg, target);
+            return GetDelimitedValues(arg, target, delimiter);
+        }
+
+        template<typename T>
+        int GetValues(const std::string& arg, std::vector<T>& target, char delimiter)
+        {
+            if (delimiter == '\0')
+                return GetValue(arg, target);
+            return GetDelimitedValues(arg, target, delimiter);
+        }
+
+        // assignment (containers accumulate values from each occurrence of an option)
+
+        template<typename T>
+        void AssignValue(T& target, T&& value)
+        {
+            target = std::move(value);
+        }
+
+        inline void AssignValue(IndexSet& target, IndexSet&& value)
+        {
+            target.merge(value);
+        }
+
+        template<typename T>
+        void AssignValue(std::list<T>& target, std::list<T>&& value)
+        {
+            target.splice(target.end(), value);
+        }
+
+        template<typename T>
+        void AssignValue(std::vector<T>& target, std::vector<T>&& value)
+        {
+            if (target.empty())
+                target = std::move(value);
+            else
+                target.insert(target.end(), std::make_move_iterator(value.begin()), std::make_move_iterator(value.end()));
+        }
+
+        template<typename Map>
+        void AssignMapValues(Map& target, Map&& value)
+        {
+            // Later values replace earlier values with the same key
+            if (target.empty())
+                target = std::move(value);
+            else
+            {
+                for (auto& element : value)
+                    target[element.first] = std::move(element.second);
+            }
+        }
+
+        template<typename K, typename V>
+        void AssignValue(std::map<K, V>& target, std::map<K, V>&& value)
+        {
+            AssignMapValues(target, std::move(value));
+        }
+
+        template<typename K, typename V>
+        void AssignValue(std::unordered_map<K, V>& target, std::unordered_map<K, V>&& value)
+        {
+            AssignMapValues(target, std::move(value));
+        }
     }
 }
 
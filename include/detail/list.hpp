@@ -48,11 +48,13 @@ namespace cyoarguments
         class List final : public ListBase
         {
         public:
-            List(std::string name, std::string description, T& target)
-                : name_(std::move(name)),
+            List(StringRef name, Text description, T& target, unsigned expand = 0)
+                : name_(name),
                 description_(std::move(description)),
-                target_(&target)
+                target_(&target),
+                expand_(expand)
             {
+                index_enum_names<T>::index();
             }
 
             void OutputUsage() const override
@@ -69,28 +71,87 @@ namespace cyoarguments
                 std::cout << '\n';
             }
 
-            bool Process(stringlist_iter& currArg, const stringlist_iter& lastArg, int& ch, bool word, bool& error) const override
+            bool Process(arglist_iter& currArg, const arglist_iter& lastArg, int& ch, bool word, bool& error) const override
             {
                 UNREFERENCED_PARAMETER(lastArg);
                 UNREFERENCED_PARAMETER(word);
+                if ((expand_ & (ExpandStdin | ExpandStdinNul)) && *currArg == "-" && !IsDataOnly())
+                {
+                    ReadValues(stdinHandle, (expand_ & ExpandStdinNul) ? '\0' : '\n', *target_);
+                    ch = 0;
+                    error = false;
+                    return true;
+                }
+
                 T value;
-                int len = GetValue(*currArg, value);
+                const bool expand = (expand_ & (ExpandGlob | ExpandDirectory)) && !IsDataOnly();
+                int len = expand ? GetExpandedValues(*currArg, value, expand_) : GetValue(*currArg, value);
                 if (len != (int)currArg->size())
                 {
                     error = true;
                     return false;
                 }
-                GetValue(*currArg, *target_);
+                AssignValue(*target_, std::move(value));
                 ch = 0;
                 error = false;
                 return true;
             }
 
         private:
-            std::string name_;
-            std::string description_;
+            const StringRef name_;
+            const Text description_;
             T* target_;
+            unsigned expand_;
         };
+
+        ////////////////////////////////
+
+        class Passthrough final : public ArgumentBase
+        {
+        public:
+            Passthrough(StringRef name, Text description, ArgumentSpan& target)
+                : name_(name),
+                description_(std::move(description)),
+                target_(&target)
+            {
+            }
+
+            void OutputUsage() const override
+            {
+                std::cout << " [-- " << name_ << "...]";
+            }
+
+            void OutputHelp() const override
+            {
+                std::cout << "  -- " << name_ << "...";
+                for (auto i = name_.size() + 6; i < optionWidth_; ++i)
+                    std::cout << ' ';
+                std::cout << description_;
+                std::cout << '\n';
+            }
+
+            bool Process(arglist_iter& currArg, const arglist_iter& lastArg, int& ch, bool word, bool& error) const override
+            {
+                UNREFERENCED_PARAMETER(currArg);
+                UNREFERENCED_PARAMETER(lastArg);
+                UNREFERENCED_PARAMETER(ch);
+                UNREFERENCED_PARAMETER(word);
+                error = false;
+                return false; //the arguments are assigned by Assign, rather than processed
+            }
+
+            void Assign(char* const* data, std::size_t index, std::size_t size) const
+            {
+                *target_ = ArgumentSpan(data, index, size);
+            }
+
+        private:
+            const StringRef name_;
+            const Text description_;
+            ArgumentSpan* target_;
+        };
+
+        using PassthroughPtr = std::unique_ptr<Passthrough>;
     }
 }
 
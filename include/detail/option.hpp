@@ -35,13 +35,31 @@ namespace cyoarguments
     {
         const char* const indent = "  ";
 
+        // Negated words (such as --no-color) clear boolean options
+        template<typename T>
+        void Negate(T& target)
+        {
+            UNREFERENCED_PARAMETER(target); //only boolean options can be negated
+        }
+
+        template<typename T>
+        void Negate(Argument<T>& target)
+        {
+            target.set(T());
+        }
+
+        inline void Negate(bool& target)
+        {
+            target = false;
+        }
+
         class OptionBase : public ArgumentBase
         {
         public:
             OptionBase() = default;
             virtual ~OptionBase() = default;
 
-            static void OutputHelpImpl(char letter, const char* word, bool isNumeric, const char* description, bool isValueless)
+            static void OutputHelpImpl(char letter, const char* word, const char* valueName, const Text& description, bool isValueless)
             {
                 std::cout << indent;
 
@@ -62,41 +80,86 @@ namespace cyoarguments
 
                 if (word != nullptr && *word != '\0')
                 {
-                    std::cout << wordPrefix << word;
-                    len += (int)(std::strlen(wordPrefix) + std::strlen(word));
-                    if (!isValueless)
+                    // Each spelling of the word is shown, such as --[no-]color, --colour
+                    ForEachSpelling(word, [&](const char* spelling, std::size_t size)
                     {
-                        if (isNumeric)
+                        if (spelling != word)
                         {
-                            std::cout << "=NUM";
-                            len += 4;
-                        }
-                        else
-                        {
-                            std::cout << "=VALUE";
-                            len += 6;
+                            std::cout << ", ";
+                            len += 2;
                         }
+                        std::cout << wordPrefix;
+                        std::cout.write(spelling, (std::streamsize)size);
+                        len += (int)(std::strlen(wordPrefix) + size);
+                    });
+                    if (!isValueless)
+                    {
+                        std::cout << '=' << valueName;
+                        len += (int)(1 + std::strlen(valueName));
                     }
                 }
 
-                for (int i = len; i < optionWidth_; ++i)
+                // The description is always separated from the option, even when it's too wide
+                for (int i = len; i < (int)optionWidth_; ++i)
+                    std::cout << ' ';
+                if (len >= (int)optionWidth_)
                     std::cout << ' ';
 
                 std::cout << description;
                 std::cout << std::endl;
             }
+
+            // Processes an argument whose word (or one of its other spellings) has been found by the
+            // Arguments, and is followed by a value or by the end of the argument
+            virtual bool ProcessWord(arglist_iter& currArg, const arglist_iter& lastArg, int ch, std::size_t wordLen, bool negated, bool& error) const = 0;
+
+            // Called as the option is added when case is ignored, so letters match in either case
+            void IgnoreCase()
+            {
+                ignoreCase_ = true;
+            }
+
+            // Calls f with each spelling of a word, such as verbose|chatty (keeping any [no-])
+            template<typename F>
+            static void ForEachSpelling(const char* word, F f)
+            {
+                for (;;)
+                {
+                    const char* const end = std::strchr(word, '|');
+                    f(word, (end != nullptr) ? (std::size_t)(end - word) : std::strlen(word));
+                    if (end == nullptr)
+                        return;
+                    word = end + 1;
+                }
+            }
+
+        protected:
+            bool Matches(char ch1, char ch2) const
+            {
+                if (ignoreCase_)
+                {
+                    if ('A' <= ch1 && ch1 <= 'Z')
+                        ch1 |= (1 << 5); //make lowercase
+                    if ('A' <= ch2 && ch2 <= 'Z')
+                        ch2 |= (1 << 5); //make lowercase
+                }
+                return (ch1 == ch2);
+            }
+
+        private:
+            bool ignoreCase_ = false;
         };
 
         using OptionPtr = std::unique_ptr<OptionBase>;
 
-        using OptionsList = std::list<OptionPtr>;
+        using OptionsList = std::vector<OptionPtr>; //the options are owned, so they don't move as the vector grows
 
         ////////////////////////////////
 
         class Group final : public OptionBase
         {
         public:
-            Group(std::string group)
+            Group(Text group)
                 : group_(std::move(group))
             {
             }
@@ -108,14 +171,29 @@ namespace cyoarguments
                 std::cout << '\n' << indent << group_ << std::endl;
             }
 
-            bool Process(stringlist_iter& currArg, const stringlist_iter& lastArg, int& ch, bool word, bool& error) const override
+            bool Process(arglist_iter& currArg, const arglist_iter& lastArg, int& ch, bool word, bool& error) const override
             {
-                currArg; lastArg; ch; word; error;
+                UNREFERENCED_PARAMETER(currArg);
+                UNREFERENCED_PARAMETER(lastArg);
+                UNREFERENCED_PARAMETER(ch);
+                UNREFERENCED_PARAMETER(word);
+                UNREFERENCED_PARAMETER(error);
+                return false;
+            }
+
+            bool ProcessWord(arglist_iter& currArg, const arglist_iter& lastArg, int ch, std::size_t wordLen, bool negated, bool& error) const override
+            {
+                UNREFERENCED_PARAMETER(currArg);
+                UNREFERENCED_PARAMETER(lastArg);
+                UNREFERENCED_PARAMETER(ch);
+                UNREFERENCED_PARAMETER(wordLen);
+                UNREFERENCED_PARAMETER(negated);
+                UNREFERENCED_PARAMETER(error);
                 return false;
             }
 
         private:
-            std::string group_;
+            const Text group_;
         };
 
         ////////////////////////////////
@@ -124,74 +202,69 @@ namespace cyoarguments
         class Option final : public OptionBase
         {
         public:
-            Option(char letter, std::string word, std::string description, T& target)
+            Option(char letter, StringRef word, Text description, T& target, char delimiter = ',')
                 : letter_(letter),
-                word_(std::move(word)),
+                delimiter_(delimiter),
+                word_(word),
                 description_(std::move(description)),
                 target_(&target)
             {
+                index_enum_names<T>::index();
             }
 
-            Option(char letter, std::string description, T& target)
+            Option(char letter, Text description, T& target, char delimiter = ',')
                 : letter_(letter),
+                delimiter_(delimiter),
                 word_(),
                 description_(std::move(description)),
                 target_(&target)
             {
+                index_enum_names<T>::index();
             }
 
-            Option(std::string word, std::string description, T& target)
+            Option(StringRef word, Text description, T& target, char delimiter = ',')
                 : letter_('\0'),
-                word_(std::move(word)),
+                delimiter_(delimiter),
+                word_(word),
                 description_(std::move(description)),
                 target_(&target)
             {
+                index_enum_names<T>::index();
             }
 
             void OutputUsage() const override { } //nothing to do (options aren't listed individually)
 
             void OutputHelp() const override
             {
-                OutputHelpImpl(letter_, word_.c_str(), isNumeric_, description_.c_str(), isValueless_);
+                OutputHelpImpl(letter_, word_.c_str(), value_name<T>::get(), description_, isValueless_);
             }
 
-            bool Process(stringlist_iter& currArg, const stringlist_iter& lastArg, int& ch, bool word, bool& error) const override
+            bool Process(arglist_iter& currArg, const arglist_iter& lastArg, int& ch, bool word, bool& error) const override
             {
                 error = false;
 
-                if (word)
-                {
-                    if (!word_.empty()
-                        && ProcessWord(currArg, lastArg, ch, error))
-                        return true;
-                }
-                else
-                {
-                    if (Matches(letter_, currArg->at(ch))
-                        && ProcessLetter(currArg, lastArg, ch, error))
-                        return true;
-                }
+                // Words are found by the Arguments, which then call ProcessWord
+                if (!word
+                    && Matches(letter_, currArg->at(ch))
+                    && ProcessLetter(currArg, lastArg, ch, error))
+                    return true;
 
                 return false;
             }
 
-        private:
-            const bool isValueless_ = is_valueless<T>::value;
-            const bool isNumeric_ = is_numeric<T>::value;
-            const bool requiresAssignment_ = requires_assignment<T>::value;
-            char letter_;
-            const std::string word_;
-            const std::string description_;
-            T* target_;
-
-            bool ProcessWord(stringlist_iter& currArg, const stringlist_iter& lastArg, int& ch, bool& error) const
+            bool ProcessWord(arglist_iter& currArg, const arglist_iter& lastArg, int ch, std::size_t wordLen, bool negated, bool& error) const override
             {
-                if (strcompare(currArg->c_str() + ch, word_.c_str()) == 0)
+                error = false;
+
+                if (ch + wordLen == currArg->size())
                 {
-                    // The argument matches the word
+                    // The argument is the word
                     if (isValueless_) //bool
                     {
-                        GetValue(*currArg, *target_);
+                        if (negated)
+                            Negate(*target_);
+                        else
+                            GetValue(*currArg, *target_);
                         return true;
                     }
 
@@ -202,49 +275,51 @@ namespace cyoarguments
                     return false;
                 }
 
-                auto wordLen = word_.size();
-                if (strncompare(currArg->c_str() + ch, word_.c_str(), wordLen) == 0)
+                // The argument continues after the word, which may be part of a longer word
+                // (for example, --names when this is --name)
+                if (isValueless_) //bool
                 {
-                    // The argument starts with the word
-                    if (isValueless_) //bool
-                    {
-                        error = true;
-                        return false;
-                    }
+                    error = (currArg->at(ch + wordLen) == '=');
+                    return false;
+                }
 
-                    if (requiresAssignment_)
-                    {
-                        if (currArg->at(ch + wordLen) != '=')
-                        {
-                            error = true;
-                            return false;
-                        }
-                        ++wordLen;
-                    }
-                    else if (currArg->at(ch + wordLen) == '=')
-                        ++wordLen;
+                if (requiresWordAssignment_)
+                {
+                    if (currArg->at(ch + wordLen) != '=')
+                        return false; //not an error!
+                    ++wordLen;
+                }
+                else if (currArg->at(ch + wordLen) == '=')
+                    ++wordLen;
 
-                    T value;
-                    int len = GetValue(currArg->substr(ch + wordLen), value);
-                    if (len >= 1)
+                T value;
+                int len = GetValues(currArg->substr(ch + wordLen), value, delimiter_);
+                if (len >= 1)
+                {
+                    if (ch + wordLen + len == currArg->size())
                     {
-                        if (ch + wordLen + len == (int)currArg->size())
-                        {
-                            GetValue(currArg->substr(ch + wordLen), *target_);
-                            return true;
-                        }
-                    }
-                    else if (GetValueFromNextArg(currArg, lastArg))
+                        AssignValue(*target_, std::move(value));
                         return true;
-
-                    error = true;
-                    return false;
+                    }
                 }
+                else if (GetValueFromNextArg(currArg, lastArg))
+                    return true;
 
-                return false; //not an error!
+                error = true;
+                return false;
             }
 
-            bool ProcessLetter(stringlist_iter& currArg, const stringlist_iter& lastArg, int& ch, bool& error) const
+        private:
+            const bool isValueless_ = is_valueless<T>::value;
+            const bool requiresAssignment_ = requires_assignment<T>::value;
+            const bool requiresWordAssignment_ = requires_word_assignment<T>::value;
+            char letter_;
+            char delimiter_; //only used by containers
+            const StringRef word_;
+            const Text description_;
+            T* target_;
+
+            bool ProcessLetter(arglist_iter& currArg, const arglist_iter& lastArg, int& ch, bool& error) const
             {
                 ++ch;
 
@@ -277,10 +352,10 @@ namespace cyoarguments
                     if (ch < (int)currArg->size())
                     {
                         T value;
-                        int len = GetValue(currArg->substr(ch), value);
+                        int len = GetValues(currArg->substr(ch), value, delimiter_);
                         if (len >= 1)
                         {
-                            GetValue(currArg->substr(ch), *target_);
+                            AssignValue(*target_, std::move(value));
                             ch += len;
                             return true;
                         }
@@ -288,11 +363,15 @@ namespace cyoarguments
                 }
 
                 // Get value from the next argument...
-                stringlist_iter nextArg = std::next(currArg);
+                arglist_iter nextArg = std::next(currArg);
                 if (nextArg != lastArg)
                 {
+                    // The value is only assigned if all of it is valid (otherwise the argument fails)
                     currArg = nextArg;
-                    ch = GetValue(*currArg, *target_);
+                    T value;
+                    ch = GetValues(*currArg, value, delimiter_);
+                    if (ch == (int)currArg->size())
+                        AssignValue(*target_, std::move(value));
                     return true;
                 }
 
@@ -301,20 +380,9 @@ namespace cyoarguments
                 return false;
             }
 
-            bool Matches(char ch1, char ch2) const
-            {
-#ifdef _MSC_VER //case insensitivity only on Windows
-                if ('A' <= ch1 && ch1 <= 'Z')
-                    ch1 |= (1 << 5); //make lowercase
-                if ('A' <= ch2 && ch2 <= 'Z')
-                    ch2 |= (1 << 5); //make lowercase
-#endif
-                return (ch1 == ch2);
-            }
-
-            bool GetValueFromNextArg(stringlist_iter& currArg, const stringlist_iter& lastArg) const
+            bool GetValueFromNextArg(arglist_iter& currArg, const arglist_iter& lastArg) const
             {
-                stringlist_iter nextArg = std::next(currArg);
+                arglist_iter nextArg = std::next(currArg);
                 if (nextArg != lastArg)
                 {
                     // Get the value from the next argument...
@@ -329,9 +397,9 @@ namespace cyoarguments
                     }
 
                     T value;
-                    if (GetValue(*nextArg, value) >= 1)
+                    if (GetValues(*nextArg, value, delimiter_) >= 1)
                     {
-                        GetValue(*nextArg, *target_);
+                        AssignValue(*target_, std::move(value));
                         currArg = nextArg;
                         return true;
                     }
@@ -340,6 +408,118 @@ namespace cyoarguments
                 return false;
             }
         };
+
+        ////////////////////////////////
+
+        class Flag final : public OptionBase
+        {
+        public:
+            Flag(char letter, StringRef word, Text description, std::uint64_t& flags, std::uint64_t mask)
+                : letter_(letter),
+                word_(word),
+                description_(std::move(description)),
+                flags_(&flags),
+                mask_(mask)
+            {
+            }
+
+            void OutputUsage() const override { } //nothing to do (options aren't listed individually)
+
+            void OutputHelp() const override
+            {
+                OutputHelpImpl(letter_, word_.c_str(), nullptr, description_, true);
+            }
+
+            bool Process(arglist_iter& currArg, const arglist_iter& lastArg, int& ch, bool word, bool& error) const override
+            {
+                UNREFERENCED_PARAMETER(lastArg);
+                error = false;
+
+                // Words are found by the Arguments, which then call ProcessWord
+                if (word)
+                    return false;
+
+                if (!Matches(letter_, currArg->at(ch)))
+                    return false;
+                ++ch;
+                if ((ch < (int)currArg->size()) && (currArg->at(ch) == '='))
+                {
+                    error = true;
+                    return false;
+                }
+                *flags_ |= mask_;
+                return true;
+            }
+
+            bool ProcessWord(arglist_iter& currArg, const arglist_iter& lastArg, int ch, std::size_t wordLen, bool negated, bool& error) const override
+            {
+                UNREFERENCED_PARAMETER(lastArg);
+                if (ch + wordLen != currArg->size())
+                {
+                    error = (currArg->at(ch + wordLen) == '='); //flags cannot be assigned
+                    return false;
+                }
+                error = false;
+                if (negated)
+                    *flags_ &= ~mask_;
+                else
+                    *flags_ |= mask_;
+                return true;
+            }
+
+            std::uint64_t* getFlags() const { return flags_; }
+            std::uint64_t getMask() const { return mask_; }
+
+        private:
+            char letter_;
+            const StringRef word_;
+            const Text description_;
+            std::uint64_t* flags_;
+            std::uint64_t mask_;
+        };
+
+        // Letters of the flags, so that a cluster of flags (such as -abc) can be set with a single store
+        struct FlagLetter
+        {
+            std::uint64_t* flags = nullptr;
+            std::uint64_t mask = 0;
+        };
+
+        using FlagLetters = std::unique_ptr<FlagLetter[]>;
+
+        // Options are indexed by their letters (which are ASCII) and words
+        const int numLetters = 128;
+
+        // Folds ASCII capitals to lowercase, 8 bytes at a time (any other bytes, including those
+        // of UTF-8 sequences, are unchanged)
+        inline void FoldCase(char* str, std::size_t len)
+        {
+            const std::uint64_t highBits = 0x8080808080808080ull;
+            std::size_t index = 0;
+            for (; index + 8 <= len; index += 8)
+            {
+                std::uint64_t bytes;
+                std::memcpy(&bytes, str + index, 8);
+                // Adding to the low 7 bits of each byte sets its high bit if it's at least 'A', or
+                // if it's beyond 'Z', without carrying into the next byte
+                const std::uint64_t low = bytes & ~highBits;
+                const std::uint64_t atLeastA = low + 0x3F3F3F3F3F3F3F3Full;
+                const std::uint64_t beyondZ = low + 0x2525252525252525ull;
+                const std::uint64_t capitals = (atLeastA ^ beyondZ) & ~bytes & highBits;
+                bytes |= (capitals >> 2); //0x80 >> 2 is the case bit
+                std::memcpy(str + index, &bytes, 8);
+            }
+            for (; index < len; ++index)
+            {
+                if ('A' <= str[index] && str[index] <= 'Z')
+                    str[index] |= (1 << 5); //make lowercase
+            }
+        }
+
+        inline bool HasCapitals(const StringRef& word)
+        {
+            return std::any_of(word.data(), word.data() + word.size(), [](char ch) { return ('A' <= ch && ch <= 'Z'); });
+        }
     }
 }
 
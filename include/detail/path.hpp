@@ -0,0 +1,162 @@
+/*
+[CyoArguments] detail/path.hpp
+
+The MIT License (MIT)
+
+Copyright (c) 2015-2016 Graham Bull
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __CYOARGUMENTS_PATH_HPP
+#define __CYOARGUMENTS_PATH_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cyoarguments
+{
+    namespace detail
+    {
+        inline void ReadAhead(const std::string& path)
+        {
+            // Failures are ignored, since any checks on the path are made later; it's opened without
+            // blocking (so a FIFO or device isn't waited on), and only a regular file is read ahead
+#if !defined(_WIN32) && defined(POSIX_FADV_WILLNEED)
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+            if (fd >= 0)
+            {
+                struct stat st;
+                if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+                    ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+                ::close(fd);
+            }
+#else
+            UNREFERENCED_PARAMETER(path);
+#endif
+        }
+
+        // A path is read ahead as soon as it's parsed, and recorded to be checked once all the arguments
+        // have been processed
+
+        template<typename T>
+        void RecordPathValue(const T& target)
+        {
+            UNREFERENCED_PARAMETER(target);
+        }
+
+        template<unsigned Checks>
+        void RecordPathValue(const Path<Checks>& target)
+        {
+            if (target.empty() || IsDataOnly())
+                return;
+            if (Checks & PathReadAhead)
+                ReadAhead(target.get());
+            ProcessState* state = CurrentProcessState();
+            if ((Checks & ~PathReadAhead) != 0 && state != nullptr)
+                state->paths.push_back({ target.get(), Checks });
+        }
+
+        // Returns the reason that a path fails its checks, or nullptr if it passes them
+        inline const char* CheckPath(const PathToCheck& path)
+        {
+#ifdef _WIN32
+            struct _stat64 st;
+            if (::_stat64(path.path.c_str(), &st) != 0)
+                return (errno == ENOENT) ? "does not exist" : "cannot be accessed";
+            const bool isFile = ((st.st_mode & _S_IFMT) == _S_IFREG);
+            const bool isDirectory = ((st.st_mode & _S_IFMT) == _S_IFDIR);
+            const bool isReadable = (::_access(path.path.c_str(), 4) == 0);
+#else
+            struct stat st;
+            if (::stat(path.path.c_str(), &st) != 0)
+                return (errno == ENOENT || errno == ENOTDIR) ? "does not exist" : "cannot be accessed";
+            const bool isFile = S_ISREG(st.st_mode);
+            const bool isDirectory = S_ISDIR(st.st_mode);
+            const bool isReadable = ((path.checks & PathIsReadable) == 0) || (::access(path.path.c_str(), R_OK) == 0);
+#endif
+            if ((path.checks & PathIsFile) && !isFile)
+                return "not a file";
+            if ((path.checks & PathIsDirectory) && !isDirectory)
+                return "not a directory";
+            if ((path.checks & PathIsReadable) && !isReadable)
+                return "not readable";
+            return nullptr;
+        }
+
+        // Long lists of paths are checked by several threads, since each check waits on the file
+        // system; if a thread can't be started, the remaining paths are checked by this thread
+        const std::size_t pathsPerThread = 64;
+
+        inline bool CheckPaths(const std::vector<PathToCheck>& paths, std::string& error)
+        {
+            std::vector<const char*> reasons(paths.size(), nullptr);
+
+            std::atomic<std::size_t> nextPath(0);
+            auto checkPaths = [&]()
+            {
+                for (;;)
+                {
+                    const std::size_t first = nextPath.fetch_add(pathsPerThread);
+                    if (first >= paths.size())
+                        break;
+                    const std::size_t last = std::min(first + pathsPerThread, paths.size());
+                    for (auto index = first; index < last; ++index)
+                        reasons[index] = CheckPath(paths[index]);
+                }
+            };
+
+            const std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+            const std::size_t numThreads = std::min(maxThreads, (paths.size() + pathsPerThread - 1) / pathsPerThread);
+
+            std::vector<std::thread> threads;
+            for (std::size_t index = 1; index < numThreads; ++index)
+            {
+                try
+                {
+                    threads.emplace_back(checkPaths);
+                }
+                catch (const std::system_error&)
+                {
+                    break;
+                }
+            }
+            checkPaths();
+            for (auto& thread : threads)
+                thread.join();
+
+            for (std::size_t index = 0; index < paths.size(); ++index)
+            {
+                if (reasons[index] != nullptr)
+                {
+                    error = "Invalid argument: ";
+                    error += paths[index].path;
+                    error += " (";
+                    error += reasons[index];
+                    error += ')';
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif //__CYOARGUMENTS_PATH_HPP
@@ -39,7 +39,7 @@ namespace cyoarguments
             RequiredBase() = default;
             virtual ~RequiredBase() = default;
 
-            virtual const std::string& getName() const = 0;
+            virtual StringRef getName() const = 0;
         };
 
         using RequiredPtr = std::unique_ptr<RequiredBase>;
@@ -52,14 +52,15 @@ namespace cyoarguments
         class Required final : public RequiredBase
         {
         public:
-            Required(std::string name, std::string description, T& target)
-                : name_(std::move(name)),
+            Required(StringRef name, Text description, T& target)
+                : name_(name),
                 description_(std::move(description)),
                 target_(&target)
             {
+                index_enum_names<T>::index();
             }
 
-            const std::string& getName() const override { return name_; }
+            StringRef getName() const override { return name_; }
 
             void OutputUsage() const override
             {
@@ -75,7 +76,7 @@ namespace cyoarguments
                 std::cout << '\n';
             }
 
-            bool Process(stringlist_iter& currArg, const stringlist_iter& lastArg, int& ch, bool word, bool& error) const override
+            bool Process(arglist_iter& currArg, const arglist_iter& lastArg, int& ch, bool word, bool& error) const override
             {
                 UNREFERENCED_PARAMETER(lastArg);
                 UNREFERENCED_PARAMETER(word);
@@ -83,7 +84,7 @@ namespace cyoarguments
                 int len = GetValue(*currArg, value);
                 if ((len >= 1) && (ch + len == (int)currArg->size()))
                 {
-                    GetValue(*currArg, *target_);
+                    AssignValue(*target_, std::move(value));
                     ch = 0;
                     error = false;
                     return true;
@@ -93,8 +94,8 @@ namespace cyoarguments
             }
 
         private:
-            const std::string name_;
-            const std::string description_;
+            const StringRef name_;
+            const Text description_;
             T* target_;
         };
     }
@@ -36,42 +36,106 @@ namespace cyoarguments
         // allow_required_argument is used to prohibit certain data types from being used as required arguments
         template<typename T> struct allow_required_argument : std::true_type { };
         template<> struct allow_required_argument<bool> : std::false_type { };
+        template<> struct allow_required_argument<Counter> : std::false_type { };
         template<typename U> struct allow_required_argument<Argument<U>> : std::false_type { };
         template<typename U> struct allow_required_argument<std::list<U>> : std::false_type { };
         template<typename U> struct allow_required_argument<std::vector<U>> : std::false_type { };
+        template<typename K, typename V> struct allow_required_argument<std::map<K, V>> : std::false_type { };
+        template<typename K, typename V> struct allow_required_argument<std::unordered_map<K, V>> : std::false_type { };
 
         // allow_list_argument is used to allow certain data types to be used as list arguments
         template<typename T> struct allow_list_argument : std::false_type { };
         template<typename U> struct allow_list_argument<std::list<U>> : std::true_type { };
         template<typename U> struct allow_list_argument<std::vector<U>> : std::true_type { };
+        template<typename K, typename V> struct allow_list_argument<std::map<K, V>> : std::true_type { };
+        template<typename K, typename V> struct allow_list_argument<std::unordered_map<K, V>> : std::true_type { };
+
+        // allow_list_expansion is used to allow glob patterns and directories to be expanded by list arguments
+        template<typename T> struct allow_list_expansion : std::false_type { };
+        template<> struct allow_list_expansion<std::list<std::string>> : std::true_type { };
+        template<> struct allow_list_expansion<std::vector<std::string>> : std::true_type { };
+        template<unsigned Checks> struct allow_list_expansion<std::list<Path<Checks>>> : std::true_type { };
+        template<unsigned Checks> struct allow_list_expansion<std::vector<Path<Checks>>> : std::true_type { };
 
         // is_valueless is used to prohibit assignments to certain data types
         // (for example, booleans cannot be assigned: --version=true)
         template<typename T> struct is_valueless : std::false_type { };
         template<> struct is_valueless<bool> : std::true_type { };
         template<> struct is_valueless<Argument<bool>> : std::true_type { };
+        template<> struct is_valueless<Counter> : std::true_type { };
+
+        // is_negatable identifies the types that can be cleared by a negated word (--no-color)
+        template<typename T> struct is_negatable : std::false_type { };
+        template<> struct is_negatable<bool> : std::true_type { };
+        template<> struct is_negatable<Argument<bool>> : std::true_type { };
+
+        // is_integer identifies the integer types that are parsed by GetInteger
+        // (the fixed-width and size types are aliases of these)
+        template<typename T> struct is_integer : std::false_type { };
+        template<> struct is_integer<signed char> : std::true_type { };
+        template<> struct is_integer<unsigned char> : std::true_type { };
+        template<> struct is_integer<short> : std::true_type { };
+        template<> struct is_integer<unsigned short> : std::true_type { };
+        template<> struct is_integer<int> : std::true_type { };
+        template<> struct is_integer<unsigned int> : std::true_type { };
+        template<> struct is_integer<long> : std::true_type { };
+        template<> struct is_integer<unsigned long> : std::true_type { };
+        template<> struct is_integer<long long> : std::true_type { };
+        template<> struct is_integer<unsigned long long> : std::true_type { };
 
         // requires_assignment determines which options can be specified without an assignment
-        // (for example, allow -j5 as well as -j=5)
-        template<typename T> struct requires_assignment : std::true_type { };
-        template<> struct requires_assignment<int> : std::false_type { };
-        template<> struct requires_assignment<Argument<int>> : std::false_type { };
-        template<> struct requires_assignment<unsigned int> : std::false_type { };
-        template<> struct requires_assignment<Argument<unsigned int>> : std::false_type { };
+        // (for example, allow -j5 as well as -j=5, and -c64k as well as -c=64k)
+        template<typename T> struct requires_assignment : std::integral_constant<bool, !is_integer<T>::value> { };
+        template<> struct requires_assignment<ByteSize> : std::false_type { };
+        template<typename Rep, typename Period> struct requires_assignment<std::chrono::duration<Rep, Period>> : std::false_type { };
+        template<> struct requires_assignment<IndexSet> : std::false_type { };
+        template<typename K, typename V> struct requires_assignment<std::map<K, V>> : std::false_type { };
+        template<typename K, typename V> struct requires_assignment<std::unordered_map<K, V>> : std::false_type { };
+        template<typename U> struct requires_assignment<Argument<U>> : requires_assignment<U> { };
+
+        // requires_word_assignment is the same for words, except that the key of a map can only follow
+        // its letter (as in -DNAME=VALUE), so that --defineX=1 isn't taken as the key X
+        template<typename T> struct requires_word_assignment : requires_assignment<T> { };
+        template<typename K, typename V> struct requires_word_assignment<std::map<K, V>> : std::true_type { };
+        template<typename K, typename V> struct requires_word_assignment<std::unordered_map<K, V>> : std::true_type { };
 
         // is_numeric determines whether NUM or VALUE is output in the help text
         // (for example, --age=NUM or --name=VALUE)
-        template<typename T> struct is_numeric : std::false_type { };
-        template<> struct is_numeric<int> : std::true_type { };
-        template<> struct is_numeric<Argument<int>> : std::true_type { };
-        template<> struct is_numeric<unsigned int> : std::true_type { };
-        template<> struct is_numeric<Argument<unsigned int>> : std::true_type { };
+        template<typename T> struct is_numeric : is_integer<T> { };
         template<> struct is_numeric<float> : std::true_type { };
-        template<> struct is_numeric<Argument<float>> : std::true_type { };
         template<> struct is_numeric<double> : std::true_type { };
-        template<> struct is_numeric<Argument<double>> : std::true_type { };
+        template<typename U> struct is_numeric<Argument<U>> : is_numeric<U> { };
         template<typename U> struct is_numeric<std::list<U>> : is_numeric<U> { };
         template<typename U> struct is_numeric<std::vector<U>> : is_numeric<U> { };
+        template<> struct is_numeric<ByteSize> : std::true_type { };
+        template<> struct is_numeric<IndexSet> : std::true_type { };
+        template<typename Rep, typename Period> struct is_numeric<std::chrono::duration<Rep, Period>> : std::true_type { };
+
+        // value_name determines the placeholder that is output in the help text
+        // (for example, --cache=SIZE, --interval=DURATION, or --mode=fast|safe|debug)
+        template<typename E> class EnumIndex;
+        template<typename T, typename Enable = void> struct value_name { static const char* get() { return is_numeric<T>::value ? "NUM" : "VALUE"; } };
+        template<typename E> struct value_name<E, typename std::enable_if<std::is_enum<E>::value>::type> { static const char* get() { return EnumIndex<E>::instance().choices(); } };
+        template<> struct value_name<ByteSize> { static const char* get() { return "SIZE"; } };
+        template<unsigned Checks> struct value_name<Path<Checks>> { static const char* get() { return "PATH"; } };
+        template<> struct value_name<HexBytes> { static const char* get() { return "HEX"; } };
+        template<> struct value_name<Base64Bytes> { static const char* get() { return "BASE64"; } };
+        template<typename Rep, typename Period> struct value_name<std::chrono::duration<Rep, Period>> { static const char* get() { return "DURATION"; } };
+        template<typename U> struct value_name<Argument<U>> : value_name<U> { };
+        template<typename U> struct value_name<std::list<U>> : value_name<U> { };
+        template<typename U> struct value_name<std::vector<U>> : value_name<U> { };
+        template<typename K, typename V> struct value_name<std::map<K, V>> { static const char* get() { return "KEY=VALUE"; } };
+        template<typename K, typename V> struct value_name<std::unordered_map<K, V>> { static const char* get() { return "KEY=VALUE"; } };
+
+        // index_enum_names indexes the names of any enum in a target as the target is added, so that
+        // duplicate names are reported then, rather than when the first value is parsed
+        template<typename T, typename Enable = void> struct index_enum_names { static void index() { } };
+        template<typename E> struct index_enum_names<E, typename std::enable_if<std::is_enum<E>::value>::type> { static void index() { EnumIndex<E>::instance(); } };
+        template<typename U> struct index_enum_names<Argument<U>> : index_enum_names<U> { };
+        template<typename U> struct index_enum_names<std::list<U>> : index_enum_names<U> { };
+        template<typename U> struct index_enum_names<std::vector<U>> : index_enum_names<U> { };
+        template<typename K, typename V> struct index_enum_names<std::map<K, V>> { static void index() { index_enum_names<K>::index(); index_enum_names<V>::index(); } };
+        template<typename K, typename V> struct index_enum_names<std::unordered_map<K, V>> { static void index() { index_enum_names<K>::index(); index_enum_names<V>::index(); } };
     }
 }
 
@@ -0,0 +1,153 @@
+/*
+[CyoArguments] detail/words.hpp
+
+The MIT License (MIT)
+
+Copyright (c) 2015-2016 Graham Bull
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef __CYOARGUMENTS_WORDS_HPP
+#define __CYOARGUMENTS_WORDS_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cyoarguments
+{
+    namespace detail
+    {
+        // A value attached to a word (such as the 5 of --jobs5, or the -1 of --offset-1) is a number,
+        // so starts with a digit, or a sign and a digit
+        inline bool StartsNumber(const char* value)
+        {
+            return std::isdigit((unsigned char)value[0])
+                || ((value[0] == '-' || value[0] == '+') && std::isdigit((unsigned char)value[1]));
+        }
+
+        // The words of the options, as a tree of their segments (such as db, pool and size in
+        // db.pool.size), so the options under a prefix (such as db.pool) are found without trying
+        // every option; each node is indexed by its whole path, so a word is found with one lookup
+        class WordTree final
+        {
+        public:
+            struct Entry
+            {
+                const OptionBase* option;
+                StringRef word; //the first spelling, as it was added (the key may be folded)
+                std::size_t order;
+                bool negated;
+            };
+
+            const Entry* Find(const StringRef& key) const
+            {
+                auto it = index_.find(key);
+                if (it == index_.end() || nodes_[it->second].entry.option == nullptr)
+                    return nullptr;
+                return &nodes_[it->second].entry;
+            }
+
+            // The length of the longest word, which no shorter word that's looked up can exceed
+            std::size_t maxSize() const { return maxSize_; }
+
+            // The key must be kept, and mustn't have been added already
+            void Add(const StringRef& key, const Entry& entry)
+            {
+                if (nodes_.empty())
+                    nodes_.emplace_back(); //the root
+                maxSize_ = std::max(maxSize_, key.size());
+
+                // The node of each segment is found (or added) by the path up to it, such as db.pool
+                std::size_t parent = 0;
+                const char* const end = key.data() + key.size();
+                for (const char* segment = key.data(); ; )
+                {
+                    auto dot = (const char*)std::memchr(segment, '.', end - segment);
+                    if (dot == nullptr)
+                        dot = end;
+                    const StringRef path(key.data(), dot - key.data());
+                    auto it = index_.find(path);
+                    std::size_t node;
+                    if (it != index_.end())
+                        node = it->second;
+                    else
+                    {
+                        node = nodes_.size();
+                        nodes_.emplace_back();
+                        nodes_[node].nextSibling = nodes_[parent].firstChild;
+                        nodes_[parent].firstChild = node;
+                        index_.emplace(path, node);
+                    }
+                    parent = node;
+                    if (dot == end)
+                        break;
+                    segment = dot + 1;
+                }
+                nodes_[parent].entry = entry;
+            }
+
+            // The options whose words are the prefix, or start with the prefix and a dot, in the
+            // order they were added (once each, whichever of their spellings are under the prefix)
+            std::vector<Entry> Collect(const StringRef& prefix) const
+            {
+                std::vector<Entry> entries;
+                if (prefix.empty())
+                {
+                    if (!nodes_.empty())
+                        CollectNode(0, entries);
+                }
+                else
+                {
+                    auto it = index_.find(prefix);
+                    if (it != index_.end())
+                        CollectNode(it->second, entries);
+                }
+                std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) { return (lhs.order < rhs.order); });
+                entries.erase(std::unique(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) { return (lhs.order == rhs.order); }), entries.end());
+                return entries;
+            }
+
+        private:
+            static const std::size_t none = (std::size_t)-1;
+
+            struct Node
+            {
+                Entry entry = { nullptr, StringRef(), 0, false };
+                std::size_t firstChild = none;
+                std::size_t nextSibling = none;
+            };
+
+            std::vector<Node> nodes_;
+            std::size_t maxSize_ = 0;
+            std::unordered_map<StringRef, std::size_t, StringRefHash> index_;
+
+            void CollectNode(std::size_t node, std::vector<Entry>& entries) const
+            {
+                if (nodes_[node].entry.option != nullptr)
+                    entries.push_back(nodes_[node].entry);
+                for (std::size_t child = nodes_[node].firstChild; child != none; child = nodes_[child].nextSibling)
+                    CollectNode(child, entries);
+            }
+        };
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif //__CYOARGUMENTS_WORDS_HPP
@@ -1 +1 @@
-g++ test.cpp -o runtest -I../include --std=c++14
+g++ test.cpp linkage.cpp -o runtest -I../include --std=c++14 -pthread
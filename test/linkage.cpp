@@ -0,0 +1,52 @@
+/*
+[CyoArguments] linkage.cpp
+
+The MIT License (MIT)
+
+Copyright (c) 2015-2016 Graham Bull
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// A second translation unit that includes the library, so the tests fail to link if anything in
+// the headers is defined without being inline
+
+#include "cyoarguments.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace cyoarguments;
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ProcessInSecondUnit(const std::vector<const char*>& args, int& num, std::string& name, HexBytes& key, std::string& error)
+{
+    Arguments arguments;
+    Counter verbose;
+    Content query;
+    Utf8String user;
+    arguments.AddOption('n', "num", "description", num);
+    arguments.AddOption("name", "description", name);
+    arguments.AddOption("key", "description", key);
+    arguments.AddOption('v', "verbose", "description", verbose);
+    arguments.AddOption("query", "description", query);
+    arguments.AddOption("user", "description", user);
+    return arguments.Process((int)args.size(), (char**)args.data(), error);
+}
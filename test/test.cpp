@@ -27,14 +27,65 @@ SOFTWARE.
 #include "cyoarguments.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <list>
+#include <map>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#ifndef _WIN32
+#   include <fcntl.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
 using namespace cyoarguments;
 
+// Defined in linkage.cpp
+bool ProcessInSecondUnit(const std::vector<const char*>& args, int& num, std::string& name, HexBytes& key, std::string& error);
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+    enum class Mode { Fast, Safe, Debug };
+
+    constexpr EnumName<Mode> modeNames[] = { { "fast", Mode::Fast }, { "safe", Mode::Safe }, { "debug", Mode::Debug } };
+
+    enum class Level { Low, High };
+
+    constexpr EnumName<Level> levelNames[] = { { "low", Level::Low }, { "high", Level::High }, { "low", Level::High } };
+
+    std::ostream& operator <<(std::ostream& os, Mode mode)
+    {
+        return os << (int)mode;
+    }
+}
+
+namespace cyoarguments
+{
+    template<>
+    struct enum_names<Mode>
+    {
+        static constexpr EnumNames<Mode> get() { return modeNames; }
+    };
+
+    template<>
+    struct enum_names<Level>
+    {
+        static constexpr EnumNames<Level> get() { return levelNames; }
+    };
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #define CHECK(value) \
@@ -612,6 +663,76 @@ namespace
 
     ///////////////////////////////////////////////////////////////////////////
 
+    // flags
+    namespace
+    {
+        class FlagBase : public Test
+        {
+        public:
+            FlagBase()
+            {
+                arguments.AddFlag('a', "all", "description", flags, 0x1);
+                arguments.AddFlag('b', "description", flags, 0x2);
+                arguments.AddFlag("cee", "description", flags, 0x4);
+                arguments.AddFlag('d', "dee", "description", others, 0x100);
+                arguments.AddOption('v', "verbose", "description", verbose);
+                arguments.AddOption('n', "description", n);
+            }
+            std::uint64_t flags = 0;
+            std::uint64_t others = 0;
+            Counter verbose;
+            int n = 0;
+        };
+
+        TEST(Flag, 1, FlagBase)
+        {
+            ProcessArgs({ "-ab", "--cee" }, true, "");
+            CHECK_EQUAL(0x7, flags);
+            CHECK_EQUAL(0, others);
+        }
+
+        TEST(Flag, 2, FlagBase)
+        {
+            ProcessArgs({ "-bd", "--all" }, true, "");
+            CHECK_EQUAL(0x3, flags);
+            CHECK_EQUAL(0x100, others);
+        }
+
+        TEST(Flag, 3, FlagBase)
+        {
+            ProcessArgs({ "-avn5" }, true, "");
+            CHECK_EQUAL(0x1, flags);
+            CHECK_EQUAL(1, verbose.get());
+            CHECK_EQUAL(5, n);
+        }
+
+        TEST(Flag, 4, FlagBase)
+        {
+            ProcessArgs({ "--all=1" }, false, "Invalid argument: --all=1");
+            CHECK_EQUAL(0, flags);
+        }
+
+        TEST(Flag, 5, FlagBase)
+        {
+            ProcessArgs({ "-a=1" }, false, "Invalid argument: -a=1");
+        }
+
+        TEST(Flag, 6, FlagBase)
+        {
+            ProcessArgs({ "-vvv", "--verbose", "-av" }, true, "");
+            CHECK_EQUAL(5, verbose.get());
+            CHECK_EQUAL(0x1, flags);
+        }
+
+        TEST(Flag, 7, FlagBase)
+        {
+            ProcessArgs({ "--verbose=2" }, false, "Invalid argument: --verbose=2");
+            CHECK_EQUAL(0, verbose.get());
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
     // int
     namespace
     {
@@ -2003,6 +2124,2197 @@ namespace
             }
         }
     }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // integers
+    namespace
+    {
+        template<typename T>
+        class IntegerBase : public Test
+        {
+        public:
+            IntegerBase()
+            {
+                arguments.AddOption('n', "num", "description", num);
+                arguments.AddRequired("first", "description", first);
+                arguments.AddList("numbers", "description", numbers);
+            }
+            T first = 0;
+            Argument<T> num;
+            std::vector<T> numbers;
+            const T min = std::numeric_limits<T>::min();
+            const T max = std::numeric_limits<T>::max();
+        };
+
+        TEST(Int8, 1, IntegerBase<std::int8_t>)
+        {
+            ProcessArgs({ "127", "--num=-128", "127" }, true, "");
+            CHECK_EQUAL(max, first);
+            CHECK_EQUAL(min, num.get());
+            CHECK_EQUAL(1, numbers.size());
+            CHECK_EQUAL(max, numbers[0]);
+        }
+
+        TEST(Int8, 2, IntegerBase<std::int8_t>)
+        {
+            ProcessArgs({ "0", "-n-128" }, true, "");
+            CHECK_EQUAL(0, first);
+            CHECK_EQUAL(min, num.get());
+        }
+
+        TEST(Int8, 3, IntegerBase<std::int8_t>)
+        {
+            ProcessArgs({ "0", "--num=-129" }, false, "Invalid argument: --num=-129");
+            CHECK(!num());
+        }
+
+        TEST(Int8, 4, IntegerBase<std::int8_t>)
+        {
+            ProcessArgs({ "0", "--num=128" }, false, "Invalid argument: --num=128");
+            CHECK(!num());
+        }
+
+        TEST(Int8, 5, IntegerBase<std::int8_t>)
+        {
+            ProcessArgs({ "0", "0", "128" }, false, "Invalid argument: 128");
+            CHECK_EQUAL(1, numbers.size());
+        }
+
+        TEST(UInt8, 1, IntegerBase<std::uint8_t>)
+        {
+            ProcessArgs({ "255", "--num=0", "255" }, true, "");
+            CHECK_EQUAL(max, first);
+            CHECK_EQUAL(min, num.get());
+            CHECK_EQUAL(1, numbers.size());
+            CHECK_EQUAL(max, numbers[0]);
+        }
+
+        TEST(UInt8, 2, IntegerBase<std::uint8_t>)
+        {
+            ProcessArgs({ "0", "-n0" }, true, "");
+            CHECK_EQUAL(0, first);
+            CHECK_EQUAL(min, num.get());
+        }
+
+        TEST(UInt8, 3, IntegerBase<std::uint8_t>)
+        {
+            ProcessArgs({ "0", "--num=-1" }, false, "Invalid argument: --num=-1");
+            CHECK(!num());
+        }
+
+        TEST(UInt8, 4, IntegerBase<std::uint8_t>)
+        {
+            ProcessArgs({ "0", "--num=256" }, false, "Invalid argument: --num=256");
+            CHECK(!num());
+        }
+
+        TEST(UInt8, 5, IntegerBase<std::uint8_t>)
+        {
+            ProcessArgs({ "0", "0", "256" }, false, "Invalid argument: 256");
+            CHECK_EQUAL(1, numbers.size());
+        }
+
+        TEST(Int16, 1, IntegerBase<std::int16_t>)
+        {
+            ProcessArgs({ "32767", "--num=-32768", "32767" }, true, "");
+            CHECK_EQUAL(max, first);
+            CHECK_EQUAL(min, num.get());
+            CHECK_EQUAL(1, numbers.size());
+            CHECK_EQUAL(max, numbers[0]);
+        }
+
+        TEST(Int16, 2, IntegerBase<std::int16_t>)
+        {
+            ProcessArgs({ "0", "-n-32768" }, true, "");
+            CHECK_EQUAL(0, first);
+            CHECK_EQUAL(min, num.get());
+        }
+
+        TEST(Int16, 3, IntegerBase<std::int16_t>)
+        {
+            ProcessArgs({ "0", "--num=-32769" }, false, "Invalid argument: --num=-32769");
+            CHECK(!num());
+        }
+
+        TEST(Int16, 4, IntegerBase<std::int16_t>)
+        {
+            ProcessArgs({ "0", "--num=32768" }, false, "Invalid argument: --num=32768");
+            CHECK(!num());
+        }
+
+        TEST(Int16, 5, IntegerBase<std::int16_t>)
+        {
+            ProcessArgs({ "0", "0", "32768" }, false, "Invalid argument: 32768");
+            CHECK_EQUAL(1, numbers.size());
+        }
+
+        TEST(UInt16, 1, IntegerBase<std::uint16_t>)
+        {
+            ProcessArgs({ "65535", "--num=0", "65535" }, true, "");
+            CHECK_EQUAL(max, first);
+            CHECK_EQUAL(min, num.get());
+            CHECK_EQUAL(1, numbers.size());
+            CHECK_EQUAL(max, numbers[0]);
+        }
+
+        TEST(UInt16, 2, IntegerBase<std::uint16_t>)
+        {
+            ProcessArgs({ "0", "-n0" }, true, "");
+            CHECK_EQUAL(0, first);
+            CHECK_EQUAL(min, num.get());
+        }
+
+        TEST(UInt16, 3, IntegerBase<std::uint16_t>)
+        {
+            ProcessArgs({ "0", "--num=-1" }, false, "Invalid argument: --num=-1");
+            CHECK(!num());
+        }
+
+        TEST(UInt16, 4, IntegerBase<std::uint16_t>)
+        {
+            ProcessArgs({ "0", "--num=65536" }, false, "Invalid argument: --num=65536");
+            CHECK(!num());
+        }
+
+        TEST(UInt16, 5, IntegerBase<std::uint16_t>)
+        {
+            ProcessArgs({ "0", "0", "65536" }, false, "Invalid argument: 65536");
+            CHECK_EQUAL(1, numbers.size());
+        }
+
+        TEST(Int32, 1, IntegerBase<std::int32_t>)
+        {
+            ProcessArgs({ "2147483647", "--num=-2147483648", "2147483647" }, true, "");
+            CHECK_EQUAL(max, first);
+            CHECK_EQUAL(min, num.get());
+            CHECK_EQUAL(1, numbers.size());
+            CHECK_EQUAL(max, numbers[0]);
+        }
+
+        TEST(Int32, 2, IntegerBase<std::int32_t>)
+        {
+            ProcessArgs({ "0", "-n-2147483648" }, true, "");
+            CHECK_EQUAL(0, first);
+            CHECK_EQUAL(min, num.get());
+        }
+
+        TEST(Int32, 3, IntegerBase<std::int32_t>)
+        {
+            ProcessArgs({ "0", "--num=-2147483649" }, false, "Invalid argument: --num=-2147483649");
+            CHECK(!num());
+        }
+
+        TEST(Int32, 4, IntegerBase<std::int32_t>)
+        {
+            ProcessArgs({ "0", "--num=2147483648" }, false, "Invalid argument: --num=2147483648");
+            CHECK(!num());
+        }
+
+        TEST(Int32, 5, IntegerBase<std::int32_t>)
+        {
+            ProcessArgs({ "0", "0", "2147483648" }, false, "Invalid argument: 2147483648");
+            CHECK_EQUAL(1, numbers.size());
+        }
+
+        TEST(UInt32, 1, IntegerBase<std::uint32_t>)
+        {
+            ProcessArgs({ "4294967295", "--num=0", "4294967295" }, true, "");
+            CHECK_EQUAL(max, first);
+            CHECK_EQUAL(min, num.get());
+            CHECK_EQUAL(1, numbers.size());
+            CHECK_EQUAL(max, numbers[0]);
+        }
+
+        TEST(UInt32, 2, IntegerBase<std::uint32_t>)
+        {
+            ProcessArgs({ "0", "-n0" }, true, "");
+            CHECK_EQUAL(0, first);
+            CHECK_EQUAL(min, num.get());
+        }
+
+        TEST(UInt32, 3, IntegerBase<std::uint32_t>)
+        {
+            ProcessArgs({ "0", "--num=-1" }, false, "Invalid argument: --num=-1");
+            CHECK(!num());
+        }
+
+        TEST(UInt32, 4, IntegerBase<std::uint32_t>)
+        {
+            ProcessArgs({ "0", "--num=4294967296" }, false, "Invalid argument: --num=4294967296");
+            CHECK(!num());
+        }
+
+        TEST(UInt32, 5, IntegerBase<std::uint32_t>)
+        {
+            ProcessArgs({ "0", "0", "4294967296" }, false, "Invalid argument: 4294967296");
+            CHECK_EQUAL(1, numbers.size());
+        }
+
+        TEST(Int64, 1, IntegerBase<std::int64_t>)
+        {
+            ProcessArgs({ "9223372036854775807", "--num=-9223372036854775808", "9223372036854775807" }, true, "");
+            CHECK_EQUAL(max, first);
+            CHECK_EQUAL(min, num.get());
+            CHECK_EQUAL(1, numbers.size());
+            CHECK_EQUAL(max, numbers[0]);
+        }
+
+        TEST(Int64, 2, IntegerBase<std::int64_t>)
+        {
+            ProcessArgs({ "0", "-n-9223372036854775808" }, true, "");
+            CHECK_EQUAL(0, first);
+            CHECK_EQUAL(min, num.get());
+        }
+
+        TEST(Int64, 3, IntegerBase<std::int64_t>)
+        {
+            ProcessArgs({ "0", "--num=-9223372036854775809" }, false, "Invalid argument: --num=-9223372036854775809");
+            CHECK(!num());
+        }
+
+        TEST(Int64, 4, IntegerBase<std::int64_t>)
+        {
+            ProcessArgs({ "0", "--num=9223372036854775808" }, false, "Invalid argument: --num=9223372036854775808");
+            CHECK(!num());
+        }
+
+        TEST(Int64, 5, IntegerBase<std::int64_t>)
+        {
+            ProcessArgs({ "0", "0", "9223372036854775808" }, false, "Invalid argument: 9223372036854775808");
+            CHECK_EQUAL(1, numbers.size());
+        }
+
+        TEST(UInt64, 1, IntegerBase<std::uint64_t>)
+        {
+            ProcessArgs({ "18446744073709551615", "--num=0", "18446744073709551615" }, true, "");
+            CHECK_EQUAL(max, first);
+            CHECK_EQUAL(min, num.get());
+            CHECK_EQUAL(1, numbers.size());
+            CHECK_EQUAL(max, numbers[0]);
+        }
+
+        TEST(UInt64, 2, IntegerBase<std::uint64_t>)
+        {
+            ProcessArgs({ "0", "-n0" }, true, "");
+            CHECK_EQUAL(0, first);
+            CHECK_EQUAL(min, num.get());
+        }
+
+        TEST(UInt64, 3, IntegerBase<std::uint64_t>)
+        {
+            ProcessArgs({ "0", "--num=-1" }, false, "Invalid argument: --num=-1");
+            CHECK(!num());
+        }
+
+        TEST(UInt64, 4, IntegerBase<std::uint64_t>)
+        {
+            ProcessArgs({ "0", "--num=18446744073709551616" }, false, "Invalid argument: --num=18446744073709551616");
+            CHECK(!num());
+        }
+
+        TEST(UInt64, 5, IntegerBase<std::uint64_t>)
+        {
+            ProcessArgs({ "0", "0", "18446744073709551616" }, false, "Invalid argument: 18446744073709551616");
+            CHECK_EQUAL(1, numbers.size());
+        }
+
+        TEST(SizeT, 1, IntegerBase<std::size_t>)
+        {
+            ProcessArgs({ "0x10", "-n", "010", "0xFFFFFFFF" }, true, "");
+            CHECK_EQUAL(16, first);
+            CHECK_EQUAL(8, num.get());
+            CHECK_EQUAL(1, numbers.size());
+            CHECK_EQUAL(4294967295u, numbers[0]);
+        }
+
+        TEST(SizeT, 2, IntegerBase<std::size_t>)
+        {
+            ProcessArgs({ "0x" }, false, "Invalid argument: 0x");
+            CHECK_EQUAL(0, first);
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // delimited values
+    namespace
+    {
+        class DelimitedBase : public Test
+        {
+        public:
+            DelimitedBase()
+            {
+                arguments.AddOption('i', "ids", "description", ids);
+                arguments.AddOption("names", "description", names, ';');
+                arguments.AddOption("text", "description", text, '\0');
+                arguments.AddOption('v', "description", v);
+            }
+            std::vector<int> ids;
+            std::list<std::string> names;
+            std::vector<std::string> text;
+            bool v = false;
+        };
+
+        TEST(Delimited, 1, DelimitedBase)
+        {
+            ProcessArgs({ "--ids=1,2,3", "--ids", "4", "-i=5,6" }, true, "");
+            CHECK_EQUAL(6, ids.size());
+            for (int i = 0; i < 6; ++i)
+                CHECK_EQUAL(i + 1, ids[i]);
+        }
+
+        TEST(Delimited, 2, DelimitedBase)
+        {
+            ProcessArgs({ "--names=a,b;c", "--text=d,e;f" }, true, "");
+            CHECK_EQUAL(2, names.size());
+            CHECK_EQUAL("a,b", names.front());
+            CHECK_EQUAL("c", names.back());
+            CHECK_EQUAL(1, text.size());
+            CHECK_EQUAL("d,e;f", text[0]);
+        }
+
+        TEST(Delimited, 3, DelimitedBase)
+        {
+            ProcessArgs({ "--ids=1,x,3" }, false, "Invalid argument: --ids=1,x,3");
+            CHECK(ids.empty());
+        }
+
+        TEST(Delimited, 4, DelimitedBase)
+        {
+            ProcessArgs({ "--ids=1,,3" }, false, "Invalid argument: --ids=1,,3");
+            CHECK(ids.empty());
+        }
+
+        TEST(Delimited, 5, DelimitedBase)
+        {
+            ProcessArgs({ "-i=1,2v" }, true, "");
+            CHECK_EQUAL(2, ids.size());
+            CHECK_EQUAL(2, ids[1]);
+            CHECK_EQUAL(true, v);
+        }
+
+        TEST(Delimited, 6, DelimitedBase)
+        {
+            ProcessArgs({ "-i=1,v" }, false, "Invalid argument: -i=1,v");
+        }
+
+        TEST(Delimited, 7, DelimitedBase)
+        {
+            // A value in the next argument is only added if all of it is valid
+            ProcessArgs({ "-i", "1,x" }, false, "Invalid argument: 1,x");
+            CHECK(ids.empty());
+            ProcessArgs({ "-i", "1,2" }, true, "");
+            CHECK_EQUAL(2, ids.size());
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // maps
+    namespace
+    {
+        class MapBase : public Test
+        {
+        public:
+            MapBase()
+            {
+                arguments.AddOption('D', "define", "description", defines);
+                arguments.AddOption("limit", "description", limits);
+                arguments.AddList("settings", "description", settings);
+            }
+            std::unordered_map<std::string, std::string> defines;
+            std::map<std::string, int> limits;
+            std::map<std::string, std::string> settings;
+        };
+
+        TEST(Map, 1, MapBase)
+        {
+            ProcessArgs({ "-DNAME=value", "-D", "EMPTY=", "--define=A=B=C", "-DNAME=other" }, true, "");
+            CHECK_EQUAL(3, defines.size());
+            CHECK_EQUAL("other", defines["NAME"]);
+            CHECK_EQUAL("", defines["EMPTY"]);
+            CHECK_EQUAL("B=C", defines["A"]);
+        }
+
+        TEST(Map, 2, MapBase)
+        {
+            ProcessArgs({ "--limit=files=100", "--limit", "threads=0x10", "x=1", "y=2" }, true, "");
+            CHECK_EQUAL(2, limits.size());
+            CHECK_EQUAL(100, limits["files"]);
+            CHECK_EQUAL(16, limits["threads"]);
+            CHECK_EQUAL(2, settings.size());
+            CHECK_EQUAL("1", settings["x"]);
+            CHECK_EQUAL("2", settings["y"]);
+        }
+
+        TEST(Map, 3, MapBase)
+        {
+            ProcessArgs({ "--limit=files=many" }, false, "Invalid argument: --limit=files=many");
+            CHECK(limits.empty());
+        }
+
+        TEST(Map, 4, MapBase)
+        {
+            ProcessArgs({ "-DNAME" }, false, "Invalid argument: -DNAME");
+            CHECK(defines.empty());
+        }
+
+        TEST(Map, 5, MapBase)
+        {
+            ProcessArgs({ "-D=value" }, false, "Invalid argument: -D=value");
+            CHECK(defines.empty());
+        }
+
+        TEST(Map, 6, MapBase)
+        {
+            // A key can follow the letter, but not the word
+            ProcessArgs({ "--defineX=1" }, false, "Invalid argument: --defineX=1");
+            ProcessArgs({ "--define5=1" }, false, "Invalid argument: --define5=1");
+            ProcessArgs({ "--limitfiles=1" }, false, "Invalid argument: --limitfiles=1");
+            CHECK(defines.empty());
+            CHECK(limits.empty());
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // @file values
+    namespace
+    {
+        class TempFile
+        {
+        public:
+            TempFile(const char* path, const std::string& contents)
+                : path_(path)
+            {
+                std::ofstream file(path, std::ios::out | std::ios::binary);
+                file << contents;
+            }
+            ~TempFile()
+            {
+                std::remove(path_);
+            }
+        private:
+            const char* path_;
+        };
+
+        class FileValueBase : public Test
+        {
+        public:
+            FileValueBase()
+            {
+                arguments.AddOption('q', "query", "description", query);
+                arguments.AddOption("user", "description", user);
+                arguments.AddRequired("first", "description", first);
+            }
+            Content query;
+            std::string user;
+            Content first;
+        };
+
+        TEST(FileValue, 1, FileValueBase)
+        {
+            TempFile file("test_query.sql", "SELECT *\nFROM t;\n");
+            ProcessArgs({ "--query=@test_query.sql", "@test_query.sql" }, true, "");
+            CHECK_EQUAL("SELECT *\nFROM t;\n", query.str());
+            CHECK_EQUAL("SELECT *\nFROM t;\n", first.str());
+        }
+
+        TEST(FileValue, 2, FileValueBase)
+        {
+            ProcessArgs({ "--query=@@user", "@" }, true, "");
+            CHECK_EQUAL("@user", query.str());
+            CHECK_EQUAL("@", first.str());
+        }
+
+        TEST(FileValue, 3, FileValueBase)
+        {
+            TempFile file("test_empty.sql", "");
+            ProcessArgs({ "-q", "@test_empty.sql", "x" }, true, "");
+            CHECK(query.empty());
+            CHECK_EQUAL("x", first.str());
+        }
+
+        TEST(FileValue, 4, FileValueBase)
+        {
+#ifdef _WIN32
+            ProcessArgs({ "--query=@test_missing.sql", "x" }, false, "Invalid argument: --query=@test_missing.sql (test_missing.sql: cannot open file)");
+#else
+            ProcessArgs({ "--query=@test_missing.sql", "x" }, false, "Invalid argument: --query=@test_missing.sql (test_missing.sql: No such file or directory)");
+#endif
+            CHECK(query.empty());
+        }
+
+        TEST(FileValue, 5, FileValueBase)
+        {
+            // A string is used as it is, even if it names a file
+            TempFile file("test_query.sql", "SELECT *\nFROM t;\n");
+            ProcessArgs({ "--user=@test_query.sql", "x" }, true, "");
+            CHECK_EQUAL("@test_query.sql", user);
+            ProcessArgs({ "--user", "@@bob", "x" }, true, "");
+            CHECK_EQUAL("@@bob", user);
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // paths
+    namespace
+    {
+        class PathBase : public Test
+        {
+        public:
+            PathBase()
+            {
+                arguments.AddOption('o', "output", "description", output);
+                arguments.AddOption("config", "description", config);
+                arguments.AddRequired("dir", "description", dir);
+                arguments.AddList("files", "description", files);
+            }
+            Path<> output;
+            Path<PathIsFile | PathIsReadable> config;
+            Path<PathIsDirectory> dir;
+            std::vector<Path<PathExists>> files;
+        };
+
+        TEST(Path, 1, PathBase)
+        {
+            TempFile file("test_config.ini", "x=1\n");
+            ProcessArgs({ "--output=@missing/out.txt", "--config=test_config.ini", ".", "test_config.ini", "." }, true, "");
+            CHECK_EQUAL("@missing/out.txt", output.get());
+            CHECK_EQUAL("test_config.ini", config.get());
+            CHECK_EQUAL(".", dir.get());
+            CHECK_EQUAL(2u, files.size());
+        }
+
+        TEST(Path, 2, PathBase)
+        {
+            ProcessArgs({ "--config=test_missing.ini", "." }, false, "Invalid argument: test_missing.ini (does not exist)");
+            ProcessArgs({ "--config=.", "." }, false, "Invalid argument: . (not a file)");
+        }
+
+        TEST(Path, 3, PathBase)
+        {
+            TempFile file("test_config.ini", "x=1\n");
+            ProcessArgs({ "test_config.ini" }, false, "Invalid argument: test_config.ini (not a directory)");
+            ProcessArgs({ ".", "test_config.ini", "test_missing/file" }, false, "Invalid argument: test_missing/file (does not exist)");
+        }
+
+        TEST(Path, 4, PathBase)
+        {
+            // Enough paths to be checked by several threads, reporting the first that fails
+            TempFile file("test_config.ini", "x=1\n");
+            std::vector<const char*> args{ "." };
+            for (int index = 0; index < 1000; ++index)
+                args.push_back("test_config.ini");
+            args[701] = "test_missing700";
+            args[901] = "test_missing900";
+            ProcessArgs(args, false, "Invalid argument: test_missing700 (does not exist)");
+            args[701] = "test_config.ini";
+            args[901] = "test_config.ini";
+            files.clear();
+            ProcessArgs(args, true, "");
+            CHECK_EQUAL(1000u, files.size());
+        }
+
+        TEST(Path, 5, Test)
+        {
+            // Reading ahead isn't a check, so a missing file is only rejected by PathIsFile
+            TempFile file("test_config.ini", "x=1\n");
+            Path<PathReadAhead> input;
+            Path<PathIsFile | PathReadAhead> config;
+            arguments.AddOption("input", "description", input);
+            arguments.AddOption("config", "description", config);
+            ProcessArgs({ "--input=test_missing.ini", "--config=test_config.ini" }, true, "");
+            CHECK_EQUAL("test_missing.ini", input.get());
+            ProcessArgs({ "--config=test_missing.ini" }, false, "Invalid argument: test_missing.ini (does not exist)");
+        }
+
+        TEST(Path, 6, PathBase)
+        {
+            // Only the paths that were given are checked, not defaults or values from before
+            config = Path<PathIsFile | PathIsReadable>("test_default.ini");
+            ProcessArgs({ "." }, true, "");
+            CHECK_EQUAL("test_default.ini", config.get());
+            {
+                TempFile file("test_config.ini", "x=1\n");
+                ProcessArgs({ "--config=test_config.ini", "." }, true, "");
+            }
+            ProcessArgs({ "." }, true, "");
+            CHECK_EQUAL("test_config.ini", config.get());
+        }
+
+#ifndef _WIN32
+        TEST(Path, 7, Test)
+        {
+            // Reading ahead a FIFO that nothing writes to doesn't wait for a writer
+            ::unlink("test_fifo");
+            CHECK((::mkfifo("test_fifo", 0600) == 0));
+            Path<PathReadAhead> input;
+            arguments.AddOption("input", "description", input);
+            ProcessArgs({ "--input=test_fifo" }, true, "");
+            CHECK_EQUAL("test_fifo", input.get());
+            ::unlink("test_fifo");
+        }
+#endif
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+#ifndef _WIN32
+    // expanded lists
+    namespace
+    {
+        class TempDir
+        {
+        public:
+            TempDir(const char* path, const std::vector<std::string>& files)
+                : path_(path)
+            {
+                ::mkdir(path, 0755);
+                for (const auto& file : files)
+                {
+                    const std::string fullPath = path_ + '/' + file;
+                    if (fullPath.back() == '/')
+                    {
+                        ::mkdir(fullPath.c_str(), 0755);
+                        dirs_.push_back(fullPath);
+                    }
+                    else
+                    {
+                        std::ofstream(fullPath) << file;
+                        files_.push_back(fullPath);
+                    }
+                }
+            }
+            ~TempDir()
+            {
+                for (const auto& file : files_)
+                    std::remove(file.c_str());
+                for (auto dir = dirs_.rbegin(); dir != dirs_.rend(); ++dir)
+                    ::rmdir(dir->c_str());
+                ::rmdir(path_.c_str());
+            }
+        private:
+            std::string path_;
+            std::vector<std::string> files_;
+            std::vector<std::string> dirs_;
+        };
+
+        class ExpandBase : public Test
+        {
+        public:
+            ExpandBase()
+                : dir("test_glob", { "b.txt", "a.txt", "c.dat", ".hidden.txt", "sub/", "sub/e.txt", "sub/d.dat" })
+            {
+            }
+            TempDir dir;
+        };
+
+        TEST(Expand, 1, ExpandBase)
+        {
+            std::vector<std::string> files;
+            arguments.AddList("files", "description", files, ExpandGlob | ExpandSorted);
+            ProcessArgs({ "test_glob/*.txt", "literal", "test_glob/*/*.dat" }, true, "");
+            CHECK_EQUAL(4u, files.size());
+            CHECK_EQUAL("test_glob/a.txt", files[0]);
+            CHECK_EQUAL("test_glob/b.txt", files[1]);
+            CHECK_EQUAL("literal", files[2]);
+            CHECK_EQUAL("test_glob/sub/d.dat", files[3]);
+        }
+
+        TEST(Expand, 2, ExpandBase)
+        {
+            std::list<Path<PathIsFile>> files;
+            arguments.AddList("files", "description", files, ExpandDirectory | ExpandSorted);
+            ProcessArgs({ "test_glob/c.dat", "test_glob" }, true, "");
+            CHECK_EQUAL(7u, files.size());
+            CHECK_EQUAL("test_glob/c.dat", files.front().get());
+            CHECK_EQUAL("test_glob/.hidden.txt", (++files.begin())->get());
+            CHECK_EQUAL("test_glob/sub/e.txt", files.back().get());
+        }
+
+        TEST(Expand, 3, ExpandBase)
+        {
+            std::vector<std::string> files;
+            arguments.AddList("files", "description", files, ExpandGlob | ExpandDirectory | ExpandSorted);
+            ProcessArgs({ "test_glob/s*" }, true, "");
+            CHECK_EQUAL(2u, files.size());
+            CHECK_EQUAL("test_glob/sub/d.dat", files[0]);
+            files.clear();
+            ProcessArgs({ "test_glob/[ab].txt", "test_glob/*/e.txt" }, true, "");
+            CHECK_EQUAL(3u, files.size());
+            CHECK_EQUAL("test_glob/sub/e.txt", files[2]);
+        }
+
+        TEST(Expand, 4, ExpandBase)
+        {
+            std::vector<std::string> files;
+            arguments.AddList("files", "description", files, ExpandGlob);
+            ProcessArgs({ "test_glob/*.csv" }, false, "Invalid argument: test_glob/*.csv (no matches)");
+            ProcessArgs({ "test_glob/*/missing.txt" }, false, "Invalid argument: test_glob/*/missing.txt (no matches)");
+            CHECK(files.empty());
+        }
+
+        TEST(Expand, 5, ExpandBase)
+        {
+            // A link to a directory is added as it is, rather than followed (so a loop ends)
+            CHECK((::symlink("..", "test_glob/sub/loop") == 0));
+            std::vector<std::string> files;
+            arguments.AddList("files", "description", files, ExpandDirectory | ExpandSorted);
+            ProcessArgs({ "test_glob/sub" }, true, "");
+            ::unlink("test_glob/sub/loop");
+            CHECK_EQUAL(3u, files.size());
+            CHECK_EQUAL("test_glob/sub/loop", files[2]);
+        }
+
+        TEST(Expand, 6, Test)
+        {
+            // Directories nested too deeply are rejected, rather than followed any further
+            std::vector<std::string> dirs{ "test_deep" };
+            for (int index = 0; index < 70; ++index)
+                dirs.push_back(dirs.back() + "/d");
+            for (const auto& dir : dirs)
+                ::mkdir(dir.c_str(), 0755);
+            std::vector<std::string> files;
+            arguments.AddList("files", "description", files, ExpandDirectory);
+            const std::string error = "Invalid argument: test_deep (directories nested too deeply: " + dirs[64] + ")";
+            ProcessArgs({ "test_deep" }, false, error.c_str());
+            for (auto dir = dirs.rbegin(); dir != dirs.rend(); ++dir)
+                ::rmdir(dir->c_str());
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // lists read from stdin
+    namespace
+    {
+        class StdinFile
+        {
+        public:
+            StdinFile(const char* path, const std::string& contents)
+                : file_(path, contents)
+            {
+                stdin_ = ::dup(STDIN_FILENO);
+                int fd = ::open(path, O_RDONLY);
+                ::dup2(fd, STDIN_FILENO);
+                ::close(fd);
+            }
+            ~StdinFile()
+            {
+                ::dup2(stdin_, STDIN_FILENO);
+                ::close(stdin_);
+            }
+        private:
+            TempFile file_;
+            int stdin_;
+        };
+
+        TEST(Stdin, 1, Test)
+        {
+            StdinFile file("test_stdin.txt", "a.txt\nb c.txt\r\n\n@d.txt");
+            std::vector<Path<>> files;
+            arguments.AddList("files", "description", files, ExpandStdin);
+            ProcessArgs({ "first.txt", "-", "last.txt" }, true, "");
+            CHECK_EQUAL(5u, files.size());
+            CHECK_EQUAL("first.txt", files[0].get());
+            CHECK_EQUAL("b c.txt", files[2].get());
+            CHECK_EQUAL("@d.txt", files[3].get());
+            CHECK_EQUAL("last.txt", files[4].get());
+        }
+
+        TEST(Stdin, 2, Test)
+        {
+            // Values that span the buffer, and a value that's longer than it
+            std::string contents;
+            for (int index = 0; index < 20000; ++index)
+                contents += std::to_string(index) + '\0';
+            contents += std::string(100000, '9');
+            StdinFile file("test_stdin.txt", contents);
+            std::list<std::string> values;
+            arguments.AddList("values", "description", values, ExpandStdinNul);
+            ProcessArgs({ "-" }, true, "");
+            CHECK_EQUAL(20001u, values.size());
+            CHECK_EQUAL("12345", *std::next(values.begin(), 12345));
+            CHECK_EQUAL(100000u, values.back().size());
+        }
+
+        TEST(Stdin, 3, Test)
+        {
+            StdinFile file("test_stdin.txt", "1\n2\nx\n");
+            std::vector<int> values;
+            arguments.AddList("values", "description", values, ExpandStdin);
+            ProcessArgs({ "-" }, false, "Invalid argument: - (invalid value: x)");
+            CHECK_EQUAL(2u, values.size());
+        }
+
+        TEST(Stdin, 4, Test)
+        {
+            std::vector<std::string> values;
+            arguments.AddList("values", "description", values);
+            ProcessArgs({ "a", "-" }, true, "");
+            CHECK_EQUAL(2u, values.size());
+            CHECK_EQUAL("-", values[1]);
+        }
+
+        TEST(Stdin, 5, Test)
+        {
+            // Any list can read stdin, but only lists of strings or paths can combine it with the
+            // expansions (which is checked at compile time)
+            StdinFile file("test_stdin.txt", std::string("1\0" "2\0", 4));
+            std::list<int> values;
+            arguments.AddList("values", "description", values, ExpandStdinNul);
+            ProcessArgs({ "-", "3" }, true, "");
+            CHECK_EQUAL(3u, values.size());
+            CHECK_EQUAL(2, *std::next(values.begin()));
+            std::vector<std::string> files;
+            Arguments arguments2;
+            arguments2.AddList("files", "description", files, ExpandGlob | ExpandStdin);
+        }
+
+        TEST(Stdin, 6, Test)
+        {
+            // Help is found before stdin is read
+            StdinFile file("test_stdin.txt", "a\nb\n");
+            std::vector<std::string> values;
+            arguments.AddList("values", "description", values, ExpandStdin);
+            ProcessArgs({ "-", "--help" }, false, "");
+            CHECK(values.empty());
+            char buffer[8];
+            CHECK_EQUAL(4, ::read(STDIN_FILENO, buffer, sizeof(buffer)));
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // NUL-separated command lines
+    namespace
+    {
+        class CmdlineBase : public Test
+        {
+        public:
+            CmdlineBase()
+            {
+                arguments.AddOption('n', "num", "description", num);
+                arguments.AddOption('v', "verbose", "description", verbose);
+                arguments.AddList("files", "description", files);
+            }
+            int num = 0;
+            bool verbose = false;
+            std::vector<std::string> files;
+
+            template<std::size_t N>
+            void ProcessCmdline(const char (&cmdline)[N], bool expectedResult, const char* expectedError)
+            {
+                std::string actualError;
+                bool actualResult = arguments.Process(cmdline, N - 1, actualError);
+                CHECK_EQUAL(expectedResult, actualResult);
+                CHECK_EQUAL(expectedError, actualError);
+            }
+        };
+
+        TEST(Cmdline, 1, CmdlineBase)
+        {
+            ProcessCmdline("/usr/bin/tool\0-n\0005\0--verbose\0a b\0\0c\0", true, "");
+            CHECK_EQUAL(5, num);
+            CHECK(verbose);
+            CHECK_EQUAL(2u, files.size());
+            CHECK_EQUAL("a b", files[0]);
+            CHECK_EQUAL("c", files[1]);
+        }
+
+        TEST(Cmdline, 2, CmdlineBase)
+        {
+            // Without a final NUL
+            ProcessCmdline("tool\0--num=7\0file", true, "");
+            CHECK_EQUAL(7, num);
+            CHECK_EQUAL(1u, files.size());
+            ProcessCmdline("tool", true, "");
+            ProcessCmdline("", true, "");
+            ProcessCmdline("tool\0--num=x\0", false, "Invalid argument: --num=x");
+        }
+
+        TEST(Cmdline, 3, CmdlineBase)
+        {
+            std::string contents("tool\0--num=3\0", 13);
+            contents += std::string(10000, 'x') + '\0';
+            TempFile file("test_cmdline", contents);
+            CmdlineReader reader;
+            CHECK(reader.Read("test_cmdline"));
+            CHECK_EQUAL(contents.size(), reader.size());
+            std::string error;
+            CHECK(arguments.Process(reader.data(), reader.size(), error));
+            CHECK_EQUAL(3, num);
+            CHECK_EQUAL(10000u, files[0].size());
+            CHECK(!reader.Read("test_missing"));
+            CHECK(reader.Read(::getpid()));
+            CHECK((reader.size() != 0));
+            CHECK_EQUAL('\0', reader.data()[reader.size() - 1]);
+        }
+
+        TEST(Cmdline, 4, Test)
+        {
+            // A command line from a buffer is only data, so nothing is read or displayed
+            TempFile file("test_query.sql", "select 1");
+            Content query;
+            std::vector<Path<PathExists | PathReadAhead>> files;
+            arguments.AddOption("query", "description", query);
+            arguments.AddList("files", "description", files, ExpandGlob | ExpandDirectory | ExpandStdin);
+            arguments.SetVersion("1.0");
+            std::string error;
+            const char cmdline[] = "tool\0--query=@test_query.sql\0-\0*.sql\0.\0test_missing";
+            CHECK(arguments.Process(cmdline, sizeof(cmdline) - 1, error));
+            CHECK_EQUAL("@test_query.sql", query.str());
+            CHECK_EQUAL(4u, files.size());
+            CHECK_EQUAL("-", files[0].get());
+            CHECK_EQUAL("*.sql", files[1].get());
+            CHECK_EQUAL(".", files[2].get());
+
+            std::ostringstream output;
+            auto buf = std::cout.rdbuf(output.rdbuf());
+            const char help[] = "tool\0a\0--help";
+            CHECK(!arguments.Process(help, sizeof(help) - 1, error));
+            CHECK_EQUAL("Help requested", error);
+            const char version[] = "tool\0--version";
+            CHECK(!arguments.Process(version, sizeof(version) - 1, error));
+            CHECK_EQUAL("Version requested", error);
+            std::cout.rdbuf(buf);
+            CHECK(output.str().empty());
+        }
+    }
+#endif
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // UTF-8
+    namespace
+    {
+        class Utf8Base : public Test
+        {
+        public:
+            Utf8Base()
+            {
+                arguments.AddOption('n', "name", "description", name);
+                arguments.AddList("files", "description", files);
+            }
+            Utf8String name;
+            std::vector<Utf8String> files;
+        };
+
+        TEST(Utf8, 1, Utf8Base)
+        {
+            ProcessArgs({ "--name=caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80 plain ascii text", "a", "\xed\x9f\xbf" }, true, "");
+            CHECK_EQUAL("caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80 plain ascii text", name.get());
+            CHECK_EQUAL(2u, files.size());
+            CHECK_EQUAL("\xed\x9f\xbf", files[1].get());
+        }
+
+        TEST(Utf8, 2, Utf8Base)
+        {
+            ProcessArgs({ "--name=abcdefgh\xff" }, false, "Invalid argument: --name=abcdefgh\xff (invalid UTF-8)");
+            ProcessArgs({ "-n=\xc0\xaf" }, false, "Invalid argument: -n=\xc0\xaf (invalid UTF-8)");
+            ProcessArgs({ "-n=\xe0\x80\x80" }, false, "Invalid argument: -n=\xe0\x80\x80 (invalid UTF-8)");
+            CHECK(name.empty());
+        }
+
+        TEST(Utf8, 3, Utf8Base)
+        {
+            ProcessArgs({ "\xed\xa0\x80" }, false, "Invalid argument: \xed\xa0\x80 (invalid UTF-8)");
+            ProcessArgs({ "\xf4\x90\x80\x80" }, false, "Invalid argument: \xf4\x90\x80\x80 (invalid UTF-8)");
+            ProcessArgs({ "\xe2\x82" }, false, "Invalid argument: \xe2\x82 (invalid UTF-8)");
+            CHECK(files.empty());
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // binary data
+    namespace
+    {
+        class BytesBase : public Test
+        {
+        public:
+            BytesBase()
+            {
+                arguments.AddOption('k', "key", "description", key);
+                arguments.AddOption("cert", "description", cert);
+            }
+            HexBytes key;
+            Base64Bytes cert;
+
+            static std::string str(const std::vector<std::uint8_t>& bytes)
+            {
+                return std::string(bytes.begin(), bytes.end());
+            }
+        };
+
+        TEST(Bytes, 1, BytesBase)
+        {
+            ProcessArgs({ "--key=00fF7a", "--cert=TWFu" }, true, "");
+            CHECK_EQUAL(3u, key.size());
+            CHECK_EQUAL(0x00, key.get()[0]);
+            CHECK_EQUAL(0xff, key.get()[1]);
+            CHECK_EQUAL(0x7a, key.get()[2]);
+            CHECK_EQUAL("Man", str(cert.get()));
+        }
+
+        TEST(Bytes, 2, BytesBase)
+        {
+            ProcessArgs({ "--cert=TWE=" }, true, "");
+            CHECK_EQUAL("Ma", str(cert.get()));
+            ProcessArgs({ "--cert", "TQ==" }, true, "");
+            CHECK_EQUAL("M", str(cert.get()));
+            ProcessArgs({ "--cert=aGVsbG8gd29ybGQ+Pz8/" }, true, "");
+            CHECK_EQUAL("hello world>???", str(cert.get()));
+        }
+
+        TEST(Bytes, 3, BytesBase)
+        {
+            ProcessArgs({ "--key=0g" }, false, "Invalid argument: --key=0g (invalid hex)");
+            CHECK(key.empty());
+            ProcessArgs({ "-k=abc" }, false, "Invalid argument: -k=abc (invalid hex)");
+            CHECK(key.empty());
+        }
+
+        TEST(Bytes, 4, BytesBase)
+        {
+            ProcessArgs({ "--cert=TWF" }, false, "Invalid argument: --cert=TWF (invalid base64)");
+            ProcessArgs({ "--cert=TW=u" }, false, "Invalid argument: --cert=TW=u (invalid base64)");
+            ProcessArgs({ "--cert=TR==" }, false, "Invalid argument: --cert=TR== (invalid base64)");
+            ProcessArgs({ "--cert=TWF=" }, false, "Invalid argument: --cert=TWF= (invalid base64)");
+            CHECK(cert.empty());
+        }
+
+        TEST(Bytes, 5, BytesBase)
+        {
+            TempFile hex("test_key.hex", "0102ff\n");
+            TempFile base64("test_cert.b64", "TWFu\r\n");
+            ProcessArgs({ "--key=@test_key.hex", "--cert", "@test_cert.b64" }, true, "");
+            CHECK_EQUAL(3u, key.size());
+            CHECK_EQUAL(0xff, key.get()[2]);
+            CHECK_EQUAL("Man", str(cert.get()));
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // ByteSize
+    namespace
+    {
+        class ByteSizeBase : public Test
+        {
+        public:
+            ByteSizeBase()
+            {
+                arguments.AddOption('c', "cache", "description", cache);
+                arguments.AddOption("batch", "description", batch);
+            }
+            ByteSize cache;
+            Argument<ByteSize> batch;
+        };
+
+        TEST(ByteSize, 1, ByteSizeBase)
+        {
+            ProcessArgs({ "--cache=4GiB", "--batch=64k" }, true, "");
+            CHECK_EQUAL(4ull << 30, cache.get());
+            CHECK_EQUAL(64u << 10, batch.get().get());
+        }
+
+        TEST(ByteSize, 2, ByteSizeBase)
+        {
+            ProcessArgs({ "-c=5MB", "--batch", "100B" }, true, "");
+            CHECK_EQUAL(5000000u, cache.get());
+            CHECK_EQUAL(100u, batch.get().get());
+        }
+
+        TEST(ByteSize, 3, ByteSizeBase)
+        {
+            ProcessArgs({ "--cache=123" }, true, "");
+            CHECK_EQUAL(123u, cache.get());
+            CHECK(!batch());
+        }
+
+        TEST(ByteSize, 4, ByteSizeBase)
+        {
+            ProcessArgs({ "--cache=16E" }, false, "Invalid argument: --cache=16E");
+            CHECK_EQUAL(0u, cache.get());
+        }
+
+        TEST(ByteSize, 5, ByteSizeBase)
+        {
+            ProcessArgs({ "--cache=4GB1" }, false, "Invalid argument: --cache=4GB1");
+            CHECK_EQUAL(0u, cache.get());
+        }
+
+        TEST(ByteSize, 6, ByteSizeBase)
+        {
+            ProcessArgs({ "--cache=G" }, false, "Invalid argument: --cache=G");
+            CHECK_EQUAL(std::string("SIZE"), detail::value_name<ByteSize>::get());
+        }
+
+        TEST(ByteSize, 7, ByteSizeBase)
+        {
+            // Like an integer, a size can follow its letter
+            ProcessArgs({ "-c64k" }, true, "");
+            CHECK_EQUAL(64u << 10, cache.get());
+            ProcessArgs({ "-c", "1M" }, true, "");
+            CHECK_EQUAL(1u << 20, cache.get());
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // std::chrono::duration
+    namespace
+    {
+        class DurationBase : public Test
+        {
+        public:
+            DurationBase()
+            {
+                arguments.AddOption("interval", "description", interval);
+                arguments.AddOption("timeout", "description", timeout);
+                arguments.AddOption("delay", "description", delay);
+            }
+            std::chrono::milliseconds interval{ 0 };
+            Argument<std::chrono::seconds> timeout;
+            std::chrono::duration<double> delay{ 0 };
+        };
+
+        TEST(Duration, 1, DurationBase)
+        {
+            ProcessArgs({ "--interval=250ms", "--timeout=2m" }, true, "");
+            CHECK_EQUAL(250, interval.count());
+            CHECK_EQUAL(120, timeout.get().count());
+        }
+
+        TEST(Duration, 2, DurationBase)
+        {
+            ProcessArgs({ "--interval=1h", "--timeout=30", "--delay=1500us" }, true, "");
+            CHECK_EQUAL(3600000, interval.count());
+            CHECK_EQUAL(30, timeout.get().count());
+            CHECK_EQUAL(0.0015, delay.count());
+        }
+
+        TEST(Duration, 3, DurationBase)
+        {
+            ProcessArgs({ "--interval=1500us" }, false, "Invalid argument: --interval=1500us");
+            CHECK_EQUAL(0, interval.count());
+        }
+
+        TEST(Duration, 4, DurationBase)
+        {
+            ProcessArgs({ "--interval=5d" }, false, "Invalid argument: --interval=5d");
+            CHECK_EQUAL(0, interval.count());
+        }
+
+        TEST(Duration, 5, DurationBase)
+        {
+            ProcessArgs({ "--interval=18446744073709551615s" }, false, "Invalid argument: --interval=18446744073709551615s");
+            CHECK_EQUAL(std::string("DURATION"), detail::value_name<std::chrono::seconds>::get());
+        }
+
+        TEST(Duration, 6, DurationBase)
+        {
+            std::chrono::seconds wait{ 0 };
+            arguments.AddOption('w', "description", wait);
+            ProcessArgs({ "-w5m" }, true, "");
+            CHECK_EQUAL(300, wait.count());
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // IndexSet
+    namespace
+    {
+        class IndexSetBase : public Test
+        {
+        public:
+            IndexSetBase()
+            {
+                arguments.AddOption('c', "cpus", "description", cpus);
+                arguments.AddOption('v', "description", v);
+            }
+            IndexSet cpus;
+            bool v = false;
+        };
+
+        TEST(IndexSet, 1, IndexSetBase)
+        {
+            ProcessArgs({ "--cpus=0-7,16-23,32" }, true, "");
+            CHECK_EQUAL(17, cpus.count());
+            CHECK(cpus.test(0));
+            CHECK(cpus.test(7));
+            CHECK(!cpus.test(8));
+            CHECK(cpus.test(16));
+            CHECK(cpus.test(23));
+            CHECK(cpus.test(32));
+            CHECK(!cpus.test(33));
+            CHECK_EQUAL(1, cpus.words().size());
+            CHECK_EQUAL(0x100ff00ffull, cpus.words()[0]);
+        }
+
+        TEST(IndexSet, 2, IndexSetBase)
+        {
+            ProcessArgs({ "-c0-9:3", "-c", "100-300" }, true, "");
+            CHECK_EQUAL(4 + 201, cpus.count());
+            CHECK(cpus.test(9));
+            CHECK(!cpus.test(10));
+            CHECK(!cpus.test(99));
+            CHECK(cpus.test(100));
+            CHECK(cpus.test(128));
+            CHECK(cpus.test(300));
+            CHECK(!cpus.test(301));
+            CHECK_EQUAL(5, cpus.words().size());
+        }
+
+        TEST(IndexSet, 3, IndexSetBase)
+        {
+            ProcessArgs({ "-c63-64v" }, true, "");
+            CHECK_EQUAL(2, cpus.count());
+            CHECK_EQUAL(true, v);
+        }
+
+        TEST(IndexSet, 4, IndexSetBase)
+        {
+            ProcessArgs({ "--cpus=7-0" }, false, "Invalid argument: --cpus=7-0");
+            CHECK(cpus.empty());
+        }
+
+        TEST(IndexSet, 5, IndexSetBase)
+        {
+            ProcessArgs({ "--cpus=0-7:0" }, false, "Invalid argument: --cpus=0-7:0");
+            CHECK(cpus.empty());
+        }
+
+        TEST(IndexSet, 6, IndexSetBase)
+        {
+            ProcessArgs({ "--cpus=0,1048576" }, false, "Invalid argument: --cpus=0,1048576");
+            CHECK(cpus.empty());
+        }
+
+        TEST(IndexSet, 7, IndexSetBase)
+        {
+            ProcessArgs({ "--cpus=0-1048575" }, true, "");
+            CHECK_EQUAL(1048576, cpus.count());
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // words that start with other words
+    namespace
+    {
+        class PrefixBase : public Test
+        {
+        public:
+            PrefixBase()
+            {
+                arguments.AddOption("name", "description", name);
+                arguments.AddOption("names", "description", names);
+                arguments.AddOption("verbose", "description", verbose);
+                arguments.AddOption("verbosely", "description", verbosely);
+            }
+            std::string name;
+            std::vector<std::string> names;
+            bool verbose = false;
+            bool verbosely = false;
+        };
+
+        TEST(Prefix, 1, PrefixBase)
+        {
+            ProcessArgs({ "--names=a", "--name=b", "--names", "c" }, true, "");
+            CHECK_EQUAL("b", name);
+            CHECK_EQUAL(2u, names.size());
+        }
+
+        TEST(Prefix, 2, PrefixBase)
+        {
+            ProcessArgs({ "--verbosely" }, true, "");
+            CHECK(verbosely);
+            CHECK(!verbose);
+        }
+
+        TEST(Prefix, 3, PrefixBase)
+        {
+            ProcessArgs({ "--namesake=a" }, false, "Invalid argument: --namesake=a");
+            ProcessArgs({ "--verbose=1" }, false, "Invalid argument: --verbose=1");
+        }
+
+        TEST(Prefix, 4, Test)
+        {
+            // A number follows a word directly, and only the words that end where it starts are tried
+            int level = 0, offset = 0, l2 = 0;
+            arguments.AddOption("level", "description", level);
+            arguments.AddOption("offset", "description", offset);
+            arguments.AddOption("l2", "description", l2);
+            ProcessArgs({ "--level12", "--offset-3", "--l2=4" }, true, "");
+            CHECK_EQUAL(12, level);
+            CHECK_EQUAL(-3, offset);
+            CHECK_EQUAL(4, l2);
+            ProcessArgs({ "--levelx1" }, false, "Invalid argument: --levelx1");
+            const std::string longArg = "--level" + std::string(100000, 'x');
+            ProcessArgs({ longArg.c_str() }, false, ("Invalid argument: " + longArg).c_str());
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // enum
+    namespace
+    {
+        class EnumBase : public Test
+        {
+        public:
+            EnumBase()
+            {
+                arguments.AddOption('m', "mode", "description", mode);
+                arguments.AddOption("modes", "description", modes);
+                arguments.AddRequired("first", "description", first);
+            }
+            Mode mode = Mode::Safe;
+            std::vector<Mode> modes;
+            Mode first = Mode::Safe;
+        };
+
+        TEST(Enum, 1, EnumBase)
+        {
+            ProcessArgs({ "--mode=debug", "fast" }, true, "");
+            CHECK_EQUAL(Mode::Debug, mode);
+            CHECK_EQUAL(Mode::Fast, first);
+        }
+
+        TEST(Enum, 2, EnumBase)
+        {
+            ProcessArgs({ "-m", "fast", "--modes=safe,debug", "debug" }, true, "");
+            CHECK_EQUAL(Mode::Fast, mode);
+            CHECK_EQUAL(2, modes.size());
+            CHECK_EQUAL(Mode::Safe, modes[0]);
+            CHECK_EQUAL(Mode::Debug, modes[1]);
+            CHECK_EQUAL(Mode::Debug, first);
+        }
+
+        TEST(Enum, 3, EnumBase)
+        {
+            ProcessArgs({ "--mode=fastest" }, false, "Invalid argument: --mode=fastest (expected fast|safe|debug)");
+            CHECK_EQUAL(Mode::Safe, mode);
+        }
+
+        TEST(Enum, 4, EnumBase)
+        {
+            ProcessArgs({ "Fast" }, false, "Invalid argument: Fast (expected fast|safe|debug)");
+            CHECK_EQUAL(Mode::Safe, first);
+        }
+
+        TEST(Enum, 5, EnumBase)
+        {
+            ProcessArgs({ "--modes=fast,slow" }, false, "Invalid argument: --modes=fast,slow (expected fast|safe|debug)");
+            CHECK(modes.empty());
+        }
+
+        TEST(Enum, 6, EnumBase)
+        {
+            ProcessArgs({ "--mode=", "debug" }, false, "Missing argument: first");
+            CHECK_EQUAL(Mode::Debug, mode);
+            CHECK_EQUAL(std::string("fast|safe|debug"), detail::value_name<Mode>::get());
+        }
+
+        TEST(Enum, 7, EnumBase)
+        {
+            // Duplicate names are found when the target is added
+            Level level = Level::Low;
+            std::vector<Level> levels;
+            CHECK_THROW("Duplicate enum name: low", arguments.AddOption("level", "description", level));
+            CHECK_THROW("Duplicate enum name: low", arguments.AddList("levels", "description", levels));
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // --
+    namespace
+    {
+        class TerminatorBase : public Test
+        {
+        public:
+            TerminatorBase()
+            {
+                arguments.AddOption('v', "verbose", "description", verbose);
+                arguments.AddOption('n', "num", "description", num);
+            }
+            bool verbose = false;
+            int num = 0;
+            std::vector<const char*> argv;
+
+            bool ProcessArgv(const std::vector<const char*>& args, std::string& error)
+            {
+                argv = { "exe_pathname" };
+                argv.insert(argv.end(), args.begin(), args.end());
+                argv.push_back(nullptr);
+                return arguments.Process((int)argv.size() - 1, (char**)argv.data(), error);
+            }
+        };
+
+        TEST(Terminator, 1, TerminatorBase)
+        {
+            ArgumentSpan command;
+            arguments.AddPassthrough("command", "description", command);
+            std::string error;
+            CHECK(ProcessArgv({ "-v", "--", "ls", "-l", "--help", "--" }, error));
+            CHECK(verbose);
+            CHECK_EQUAL(4u, command.size());
+            CHECK_EQUAL(3u, command.index());
+            CHECK((command.data() == (char**)&argv[3]));
+            CHECK_EQUAL(std::string("ls"), command[0]);
+            CHECK_EQUAL(std::string("--help"), command[2]);
+            CHECK((command.data()[command.size()] == nullptr));
+        }
+
+        TEST(Terminator, 2, TerminatorBase)
+        {
+            // A value can't be taken from after --
+            ArgumentSpan command;
+            arguments.AddPassthrough("command", "description", command);
+            std::string error;
+            CHECK(!ProcessArgv({ "-n", "--", "5" }, error));
+            CHECK_EQUAL("Invalid argument: -n", error);
+            CHECK(ProcessArgv({ "-n5", "--" }, error));
+            CHECK_EQUAL(5, num);
+            CHECK(command.empty());
+            CHECK(ProcessArgv({ "-v" }, error));
+            CHECK(command.empty());
+        }
+
+        TEST(Terminator, 3, TerminatorBase)
+        {
+            // Without a passthrough argument, the arguments after -- are positional
+            std::string first;
+            std::vector<std::string> rest;
+            arguments.AddRequired("first", "description", first);
+            arguments.AddList("rest", "description", rest);
+            ProcessArgs({ "-v", "--", "-n", "--help", "--", "-" }, true, "");
+            CHECK(verbose);
+            CHECK_EQUAL(0, num);
+            CHECK_EQUAL("-n", first);
+            CHECK_EQUAL(3u, rest.size());
+            CHECK_EQUAL("--help", rest[0]);
+            CHECK_EQUAL("--", rest[1]);
+        }
+
+        TEST(Terminator, 4, TerminatorBase)
+        {
+            ArgumentSpan command;
+            arguments.AddPassthrough("command", "description", command);
+            std::string error;
+            const char cmdline[] = "tool\0-v\0--\0echo\0hi";
+            CHECK(arguments.Process(cmdline, sizeof(cmdline) - 1, error));
+            CHECK((command.data() == nullptr));
+            CHECK_EQUAL(3u, command.index());
+            CHECK_EQUAL(2u, command.size());
+            CHECK_THROW("Only one passthrough argument can be specified", arguments.AddPassthrough("other", "description", command));
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // unknown arguments
+    namespace
+    {
+        class UnknownBase : public Test
+        {
+        public:
+            UnknownBase()
+            {
+                arguments.AddOption('v', "verbose", "description", verbose);
+                arguments.AddOption('n', "num", "description", num);
+                arguments.CollectUnknown(unknown);
+            }
+            bool verbose = false;
+            int num = 0;
+            std::vector<int> unknown;
+        };
+
+        TEST(Unknown, 1, UnknownBase)
+        {
+            ProcessArgs({ "--level=3", "-v", "-xyz", "--num=4", "--other", "value", "--verbosely" }, true, "");
+            CHECK(verbose);
+            CHECK_EQUAL(4, num);
+            CHECK_EQUAL(5u, unknown.size());
+            CHECK_EQUAL(1, unknown[0]);
+            CHECK_EQUAL(3, unknown[1]);
+            CHECK_EQUAL(5, unknown[2]);
+            CHECK_EQUAL(6, unknown[3]);
+            CHECK_EQUAL(7, unknown[4]);
+        }
+
+        TEST(Unknown, 2, UnknownBase)
+        {
+            // Known options with invalid values still fail
+            ProcessArgs({ "--other", "--num=x" }, false, "Invalid argument: --num=x");
+            ProcessArgs({ "--verbose=yes" }, false, "Invalid argument: --verbose=yes");
+            ProcessArgs({ "-vx" }, false, "Invalid argument: -vx");
+        }
+
+        TEST(Unknown, 3, UnknownBase)
+        {
+            // Positional arguments are only unknown once the required and list arguments are full
+            std::string first;
+            arguments.AddRequired("first", "description", first);
+            ProcessArgs({ "a", "-q", "b", "--", "-c" }, true, "");
+            CHECK_EQUAL("a", first);
+            CHECK_EQUAL(3u, unknown.size());
+            CHECK_EQUAL(2, unknown[0]);
+            CHECK_EQUAL(3, unknown[1]);
+            CHECK_EQUAL(5, unknown[2]);
+            ProcessArgs({ "a" }, true, "");
+            CHECK(unknown.empty());
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // modules
+    namespace
+    {
+        struct NetModule
+        {
+            int port = 0;
+            std::string host;
+
+            void operator ()(Arguments& arguments)
+            {
+                arguments.AddOption('p', "port", "description", port);
+                arguments.AddOption("host", "description", host);
+            }
+        };
+
+        class ModuleBase : public Test
+        {
+        public:
+            ModuleBase()
+            {
+                arguments.AddOption('n', "num", "description", num);
+                arguments.AddModule("Network", std::ref(net));
+                arguments.AddModule("Storage", [this](Arguments& args)
+                {
+                    args.AddOption("cache", "description", cache);
+                    args.AddOption('N', "numbers", "description", numbers);
+                });
+            }
+            int num = 0;
+            NetModule net;
+            ByteSize cache;
+            std::vector<int> numbers;
+        };
+
+        TEST(Module, 1, ModuleBase)
+        {
+            ProcessArgs({ "--port=80", "--num=3", "--host=example.com", "--cache=1k", "-N=4", "--numbers=5", "-p8080" }, true, "");
+            CHECK_EQUAL(8080, net.port);
+            CHECK_EQUAL(3, num);
+            CHECK_EQUAL("example.com", net.host);
+            CHECK_EQUAL(1024u, cache.get());
+            CHECK_EQUAL(2u, numbers.size());
+        }
+
+        TEST(Module, 2, ModuleBase)
+        {
+            // A number can follow a word directly
+            ProcessArgs({ "--num7", "--port", "9" }, true, "");
+            CHECK_EQUAL(7, num);
+            CHECK_EQUAL(9, net.port);
+            ProcessArgs({ "--hostname=x" }, false, "Invalid argument: --hostname=x");
+        }
+
+        TEST(Module, 3, ModuleBase)
+        {
+            int other = 0;
+            CHECK_THROW("Duplicate option: port (in module Other)",
+                arguments.AddModule("Other", [&](Arguments& args) { args.AddOption("port", "description", other); }));
+            CHECK_THROW("Duplicate option: p (in module Other)",
+                arguments.AddModule("Other", [&](Arguments& args) { args.AddOption('p', "description", other); }));
+            CHECK_THROW("Duplicate option: n",
+                arguments.AddOption('n', "other", "description", other));
+            CHECK_THROW("Modules cannot be nested",
+                arguments.AddModule("Outer", [&](Arguments& args) { args.AddModule("Inner", [](Arguments&) { }); }));
+            arguments.AddOption('o', "other", "description", other);
+            ProcessArgs({ "-o5" }, true, "");
+            CHECK_EQUAL(5, other);
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // commands
+    namespace
+    {
+        class CommandBase : public Test
+        {
+        public:
+            CommandBase()
+            {
+                arguments.AddOption('v', "verbose", "description", verbose);
+                arguments.AddCommand("build", "description", [this](Arguments& args)
+                {
+                    command = "build";
+                    args.AddOption('j', "jobs", "description", jobs);
+                    args.AddList("targets", "description", targets);
+                });
+                arguments.AddCommand("status", "description", [this](Arguments&)
+                {
+                    command = "status";
+                });
+            }
+            bool verbose = false;
+            std::string command;
+            int jobs = 0;
+            std::vector<std::string> targets;
+        };
+
+        TEST(Command, 1, CommandBase)
+        {
+            ProcessArgs({ "-v", "build", "-j4", "all", "-v" }, false, "Invalid argument: -v");
+            CHECK_EQUAL("build", command);
+            CHECK_EQUAL(4, jobs);
+            ProcessArgs({ "--verbose", "build", "--jobs=8", "lib", "exe" }, true, "");
+            CHECK(verbose);
+            CHECK_EQUAL(8, jobs);
+            CHECK_EQUAL(3u, targets.size());
+        }
+
+        TEST(Command, 2, CommandBase)
+        {
+            // Only the selected command's registrar is called
+            ProcessArgs({ "status" }, true, "");
+            CHECK_EQUAL("status", command);
+            CHECK_EQUAL(0, jobs);
+            ProcessArgs({ "status", "extra" }, false, "Invalid argument: extra");
+        }
+
+        TEST(Command, 3, CommandBase)
+        {
+            ProcessArgs({ "-v" }, false, "Missing command");
+            ProcessArgs({ "deploy" }, false, "Invalid argument: deploy (unknown command)");
+            ProcessArgs({ "--jobs=4", "build" }, false, "Invalid argument: --jobs=4");
+            CHECK(command.empty());
+        }
+
+        TEST(Command, 4, CommandBase)
+        {
+            std::string name;
+            CHECK_THROW("Commands cannot be combined with required or list arguments", arguments.AddRequired("name", "description", name));
+            CHECK_THROW("Duplicate command: build", arguments.AddCommand("build", "description", [](Arguments&) { }));
+            CHECK_THROW("Command contains a non-alphanumeric character: build.all", arguments.AddCommand("build.all", "description", [](Arguments&) { }));
+            CHECK_THROW("Command must have a name", arguments.AddCommand("", "description", [](Arguments&) { }));
+        }
+
+        TEST(Command, 5, CommandBase)
+        {
+            // The command's unknown arguments are collected with the others, as indexes into argv
+            std::vector<int> unknown;
+            arguments.CollectUnknown(unknown);
+            ProcessArgs({ "--level=1", "build", "--unknown", "-j2", "all" }, true, "");
+            CHECK_EQUAL(2u, unknown.size());
+            CHECK_EQUAL(1, unknown[0]);
+            CHECK_EQUAL(3, unknown[1]);
+            CHECK_EQUAL(2, jobs);
+        }
+
+        TEST(Command, 6, CommandBase)
+        {
+            // The arguments after -- are passed through, rather than given to the command (the
+            // span refers to argv, so it's kept while the span is read)
+            ArgumentSpan passthrough;
+            arguments.AddPassthrough("command", "description", passthrough);
+            std::vector<const char*> argv{ "exe_pathname", "build", "lib", "--", "make", "-j", nullptr };
+            std::string error;
+            CHECK(arguments.Process((int)argv.size() - 1, (char**)argv.data(), error));
+            CHECK_EQUAL("", error);
+            CHECK_EQUAL(1u, targets.size());
+            CHECK_EQUAL(2u, passthrough.size());
+            CHECK_EQUAL(4u, passthrough.index());
+            CHECK_EQUAL(std::string("make"), passthrough[0]);
+            CHECK_EQUAL(std::string("-j"), passthrough[1]);
+        }
+
+        TEST(Command, 7, Test)
+        {
+            // The paths are checked after the command's arguments have been processed
+            TempFile file("test_config.ini", "x=1\n");
+            Path<PathIsFile> config;
+            Path<PathIsDirectory> dir;
+            int jobs = 0;
+            arguments.AddOption("config", "description", config);
+            arguments.AddCommand("build", "description", [&](Arguments& args)
+            {
+                args.AddOption("dir", "description", dir);
+                args.AddOption("jobs", "description", jobs);
+            });
+            ProcessArgs({ "--config=test_config.ini", "build", "--dir=." }, true, "");
+            ProcessArgs({ "--config=test_config.ini", "build", "--dir=test_config.ini" }, false, "Invalid argument: test_config.ini (not a directory)");
+            ProcessArgs({ "--config=test_missing.ini", "build", "--jobs=x" }, false, "Invalid argument: --jobs=x");
+            ProcessArgs({ "--config=test_missing.ini", "build", "--jobs=2" }, false, "Invalid argument: test_missing.ini (does not exist)");
+            CHECK_EQUAL(2, jobs);
+        }
+
+        TEST(Command, 8, CommandBase)
+        {
+            // A command is still required when -- comes before it
+            ArgumentSpan passthrough;
+            arguments.AddPassthrough("command", "description", passthrough);
+            std::vector<const char*> argv{ "exe_pathname", "-v", "--", "make", nullptr };
+            std::string error;
+            CHECK(!arguments.Process((int)argv.size() - 1, (char**)argv.data(), error));
+            CHECK_EQUAL("Missing command", error);
+            CHECK(command.empty());
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // help text
+    namespace
+    {
+        class TextBase : public Test
+        {
+        public:
+            TextBase()
+            {
+                arguments.SetHeader([this] { ++provided; return std::string("Header"); });
+                arguments.AddGroup(std::string("Group"));
+                arguments.AddOption('n', "num", [this] { ++provided; return "number " + std::to_string(provided); }, num);
+                arguments.SetFooter("Footer");
+            }
+            int provided = 0;
+            int num = 0;
+
+            std::string DisplayHelp()
+            {
+                std::ostringstream output;
+                auto buf = std::cout.rdbuf(output.rdbuf());
+                ProcessArgs({ "--help" }, false, "");
+                std::cout.rdbuf(buf);
+                return output.str();
+            }
+        };
+
+        TEST(Text, 1, TextBase)
+        {
+            // The providers are only called when the help is displayed
+            ProcessArgs({ "-n5" }, true, "");
+            CHECK_EQUAL(5, num);
+            CHECK_EQUAL(0, provided);
+            std::string help = DisplayHelp();
+            CHECK_EQUAL(2, provided);
+            CHECK((help.find("Header\n") == 0));
+            CHECK((help.find("Group") != std::string::npos));
+            CHECK((help.find("number 2") != std::string::npos));
+            CHECK((help.find("Footer") != std::string::npos));
+        }
+
+        TEST(Text, 2, TextBase)
+        {
+            // Only a text given as a literal is referred to, so a buffer or pointer is copied
+            char buffer[] = "before";
+            Text copied(buffer);
+            char* pointer = buffer;
+            Text copiedPointer(pointer);
+            std::strcpy(buffer, "after");
+            CHECK_EQUAL("before", copied.str());
+            CHECK_EQUAL("before", copiedPointer.str());
+            CHECK_EQUAL("literal", Text::Literal("literal").str());
+            CHECK_EQUAL("literal", Text("literal").str());
+            CHECK_EQUAL("owned", Text(std::string("owned")).str());
+            CHECK(Text().empty());
+            CHECK(!Text([] { return std::string(); }).empty());
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // names
+    namespace
+    {
+        class NameBase : public Test
+        {
+        public:
+            NameBase()
+            {
+                // Names that aren't literals are interned, so they needn't outlive the call
+                std::string word = "count";
+                arguments.AddOption('c', word, "description", count);
+                word = "size";
+                arguments.AddOption(word.c_str(), "description", size);
+                arguments.AddRequired(std::string("file"), "description", file);
+            }
+            int count = 0;
+            int size = 0;
+            std::string file;
+        };
+
+        TEST(Name, 1, NameBase)
+        {
+            ProcessArgs({ "--count=3", "--size", "7", "name" }, true, "");
+            CHECK_EQUAL(3, count);
+            CHECK_EQUAL(7, size);
+            CHECK_EQUAL("name", file);
+            ProcessArgs({}, false, "Missing argument: file");
+        }
+
+        TEST(Name, 2, NameBase)
+        {
+            int other = 0;
+            CHECK_THROW("Duplicate option: count", arguments.AddOption(std::string("count"), "description", other));
+            CHECK_THROW("Duplicate option: size", arguments.AddOption("size", "description", other));
+            CHECK_THROW("Option contains a non-alphanumeric character: a-b", arguments.AddOption(std::string("a-b"), "description", other));
+        }
+
+        TEST(Name, 3, Test)
+        {
+            // A word in a buffer is copied, since the buffer can change (or go) after it's added
+            int num = 0, level = 0;
+            {
+                char buffer[] = "num";
+                arguments.AddOption(buffer, "description", num);
+                std::strcpy(buffer, "xyz");
+            }
+            static const char word[] = "level";
+            arguments.AddOption(Name::Literal(word), "description", level);
+            ProcessArgs({ "--num=2", "--level=3" }, true, "");
+            CHECK_EQUAL(2, num);
+            CHECK_EQUAL(3, level);
+            ProcessArgs({ "--xyz=2" }, false, "Invalid argument: --xyz=2");
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // case
+    namespace
+    {
+        class CaseBase : public Test
+        {
+        public:
+            CaseBase()
+            {
+                arguments.SetIgnoreCase(true);
+                arguments.AddOption('v', "Verbose", "description", verbose);
+                arguments.AddOption(std::string("outputDir"), "description", outputDir);
+                arguments.AddOption("jobs", "description", jobs);
+                arguments.AddFlag('A', "all", "description", flags, 0x1);
+                arguments.AddFlag('b', "Backup", "description", flags, 0x2);
+            }
+            bool verbose = false;
+            std::string outputDir;
+            int jobs = 0;
+            std::uint64_t flags = 0;
+        };
+
+        TEST(Case, 1, CaseBase)
+        {
+            // Only the words are folded, not the values
+            ProcessArgs({ "--VERBOSE", "--OutputDIR=MixedCase", "--JOBS8", "-ab" }, true, "");
+            CHECK(verbose);
+            CHECK_EQUAL("MixedCase", outputDir);
+            CHECK_EQUAL(8, jobs);
+            CHECK_EQUAL(3u, flags);
+            ProcessArgs({ "-V", "--outputdir", "Dir", "--ALL", "--backup" }, true, "");
+            CHECK_EQUAL("Dir", outputDir);
+            ProcessArgs({ "--Help" }, false, "");
+        }
+
+        TEST(Case, 2, CaseBase)
+        {
+            int other = 0;
+            CHECK_THROW("Duplicate option: VERBOSE", arguments.AddOption("VERBOSE", "description", other));
+            CHECK_THROW("Duplicate option: B", arguments.AddOption('B', "description", other));
+            CHECK_THROW("Case must be ignored before adding options", arguments.SetIgnoreCase(false));
+        }
+
+        TEST(Case, 3, Test)
+        {
+            // Folded 8 bytes at a time, then the rest (only ASCII capitals are changed)
+            std::string str = "@AZ[`az{\xC3\x84Hello, WORLD! \xC3\x96";
+            cyoarguments::detail::FoldCase(&str[0], str.size());
+            CHECK_EQUAL("@az[`az{\xC3\x84hello, world! \xC3\x96", str);
+            bool verbose = false;
+            arguments.AddOption("verbose", "description", verbose);
+#ifndef _MSC_VER
+            ProcessArgs({ "--VERBOSE" }, false, "Invalid argument: --VERBOSE");
+#endif
+        }
+
+        TEST(Case, 4, CaseBase)
+        {
+            // A value attached straight to the word keeps its case
+            ByteSize cache;
+            arguments.AddOption("cache", "description", cache);
+            ProcessArgs({ "--Cache4GiB", "--CACHE=64k" }, true, "");
+            CHECK_EQUAL(64u << 10, cache.get());
+            ProcessArgs({ "--CACHE4GiB" }, true, "");
+            CHECK_EQUAL(4ull << 30, cache.get());
+        }
+
+        TEST(Case, 5, CaseBase)
+        {
+            // Errors show the argument as it was given, not folded
+            ProcessArgs({ "--Unknown=X" }, false, "Invalid argument: --Unknown=X");
+            ProcessArgs({ "--JOBS=Eight" }, false, "Invalid argument: --JOBS=Eight");
+            ProcessArgs({ "--Verbose", "--JobsX" }, false, "Invalid argument: --JobsX");
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // dotted words
+    namespace
+    {
+        class DottedBase : public Test
+        {
+        public:
+            DottedBase()
+            {
+                arguments.AddOption("db.pool.size", "description", poolSize);
+                arguments.AddOption("db.host", "description", host);
+                arguments.AddOption("cache.l2.ways", "description", ways);
+                arguments.AddOption("db.pool.timeout", "description", timeout);
+                arguments.AddOption('d', "db", "description", db);
+            }
+            int poolSize = 0;
+            std::string host;
+            int ways = 0;
+            int timeout = 0;
+            bool db = false;
+
+            std::string DisplayHelp(const char* arg)
+            {
+                std::ostringstream output;
+                auto buf = std::cout.rdbuf(output.rdbuf());
+                ProcessArgs({ arg }, false, "");
+                std::cout.rdbuf(buf);
+                return output.str();
+            }
+        };
+
+        TEST(Dotted, 1, DottedBase)
+        {
+            ProcessArgs({ "--db.pool.size=32", "--cache.l2.ways", "8", "--db.host=example.com", "--db.pool.timeout5", "--db" }, true, "");
+            CHECK_EQUAL(32, poolSize);
+            CHECK_EQUAL(8, ways);
+            CHECK_EQUAL("example.com", host);
+            CHECK_EQUAL(5, timeout);
+            CHECK(db);
+            ProcessArgs({ "--db.pool=1" }, false, "Invalid argument: --db.pool=1");
+            ProcessArgs({ "--db.pool.sizes=1" }, false, "Invalid argument: --db.pool.sizes=1");
+        }
+
+        TEST(Dotted, 2, DottedBase)
+        {
+            // The options under a prefix are in the order they were added
+            CHECK((stringlist{ "db.pool.size", "db.pool.timeout" } == arguments.GetOptionWords("db.pool")));
+            CHECK((stringlist{ "db.pool.size", "db.host", "db.pool.timeout", "db" } == arguments.GetOptionWords("db")));
+            CHECK_EQUAL(5u, arguments.GetOptionWords("").size());
+            CHECK(arguments.GetOptionWords("db.po").empty());
+            CHECK(arguments.GetOptionWords("cache.l2.ways.x").empty());
+        }
+
+        TEST(Dotted, 3, DottedBase)
+        {
+            const std::string help = DisplayHelp("--help=db.pool");
+            CHECK((help.find("--db.pool.size") != std::string::npos));
+            CHECK((help.find("--db.pool.timeout") != std::string::npos));
+            CHECK((help.find("--db.host") == std::string::npos));
+            CHECK((help.find("--cache") == std::string::npos));
+            CHECK((DisplayHelp("--help=").find("--cache.l2.ways") != std::string::npos));
+        }
+
+        TEST(Dotted, 5, DottedBase)
+        {
+            // A prefix that no option is under is reported rather than listing no options
+            std::ostringstream output;
+            auto buf = std::cout.rdbuf(output.rdbuf());
+            ProcessArgs({ "--help=db.po" }, false, "Invalid argument: --help=db.po (unknown prefix)");
+            ProcessArgs({ "--help=xyz" }, false, "Invalid argument: --help=xyz (unknown prefix)");
+            std::cout.rdbuf(buf);
+            CHECK(output.str().empty());
+        }
+
+        TEST(Dotted, 4, DottedBase)
+        {
+            int other = 0;
+            CHECK_THROW("Option contains an empty segment: .db", arguments.AddOption(".db", "description", other));
+            CHECK_THROW("Option contains an empty segment: db.", arguments.AddOption("db.", "description", other));
+            CHECK_THROW("Option contains an empty segment: db..size", arguments.AddOption("db..size", "description", other));
+            CHECK_THROW("Duplicate option: db.host", arguments.AddOption("db.host", "description", other));
+            arguments.AddOption("db.pool", "description", other);
+            ProcessArgs({ "--db.pool=7" }, true, "");
+            CHECK_EQUAL(7, other);
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // spellings
+    namespace
+    {
+        class SpellingBase : public Test
+        {
+        public:
+            SpellingBase()
+            {
+                arguments.AddOption('c', "[no-]color|colour", "description", color);
+                arguments.AddOption("verbose|chatty|talkative", "description", verbose);
+                arguments.AddOption("jobs|threads", "description", jobs);
+                arguments.AddOption("[no-]cache", "description", cache);
+                arguments.AddFlag("[no-]force|overwrite", "description", flags, 0x1);
+            }
+            bool color = false;
+            Argument<bool> verbose;
+            int jobs = 0;
+            Argument<bool> cache;
+            std::uint64_t flags = 0;
+
+            std::string DisplayHelp()
+            {
+                std::ostringstream output;
+                auto buf = std::cout.rdbuf(output.rdbuf());
+                ProcessArgs({ "--help" }, false, "");
+                std::cout.rdbuf(buf);
+                return output.str();
+            }
+        };
+
+        TEST(Spelling, 1, SpellingBase)
+        {
+            ProcessArgs({ "--colour", "--chatty", "--threads=4", "--overwrite" }, true, "");
+            CHECK(color);
+            CHECK(verbose.get());
+            CHECK_EQUAL(4, jobs);
+            CHECK_EQUAL(1u, flags);
+            ProcessArgs({ "--no-color", "--no-cache", "--no-force", "--jobs8", "--threads7" }, true, "");
+            CHECK(!color);
+            CHECK(cache());
+            CHECK(!cache.get());
+            CHECK_EQUAL(0u, flags);
+            CHECK_EQUAL(7, jobs);
+            ProcessArgs({ "--no-colour" }, false, "Invalid argument: --no-colour"); //only color is negated
+            ProcessArgs({ "--no-verbose" }, false, "Invalid argument: --no-verbose");
+            ProcessArgs({ "--no-color=1" }, false, "Invalid argument: --no-color=1");
+        }
+
+        TEST(Spelling, 2, SpellingBase)
+        {
+            // Each option is shown once, with all its spellings
+            const std::string help = DisplayHelp();
+            CHECK((help.find("-c, --[no-]color, --colour") != std::string::npos));
+            CHECK((help.find("--verbose, --chatty, --talkative") != std::string::npos));
+            CHECK((help.find("--jobs, --threads=NUM") != std::string::npos));
+            CHECK((help.find("--colour description\n") != std::string::npos)); //too wide, but still separated
+            CHECK((help.find("--talkative description\n") != std::string::npos));
+            CHECK((stringlist{ "color", "verbose", "jobs", "cache", "force" } == arguments.GetOptionWords("")));
+        }
+
+        TEST(Spelling, 3, SpellingBase)
+        {
+            int other = 0;
+            bool flag = false;
+            CHECK_THROW("Only boolean options can be negated: [no-]other", arguments.AddOption("[no-]other", "description", other));
+            CHECK_THROW("Duplicate option: chatty", arguments.AddOption("other|chatty", "description", other));
+            CHECK_THROW("Duplicate option: cache", arguments.AddOption("[no-]other|cache", "description", flag));
+            CHECK_THROW("Duplicate option: other", arguments.AddOption("other|other", "description", other));
+            CHECK_THROW("Option cannot be blank", arguments.AddOption("other||more", "description", other));
+            CHECK_THROW("Option contains a non-alphanumeric character: other[no-]", arguments.AddOption("other[no-]", "description", flag));
+            arguments.AddOption("other", "description", other);
+            ProcessArgs({ "--other=3" }, true, "");
+            CHECK_EQUAL(3, other);
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // version
+    namespace
+    {
+        class VersionBase : public Test
+        {
+        public:
+            VersionBase()
+            {
+                arguments.DisableHelp();
+                arguments.SetVersion("version");
+                arguments.AddOption('a', "description", a);
+                arguments.AddOption("name", "description", name);
+            }
+            int a = 0;
+            std::string name;
+        };
+
+        TEST(Version, 1, VersionBase)
+        {
+            ProcessArgs({ "--version" }, false, "");
+        }
+
+        TEST(Version, 2, VersionBase)
+        {
+            // Nothing is assigned once version is found
+            ProcessArgs({ "-a1", "--name=value", "--version" }, false, "");
+            CHECK_EQUAL(0, a);
+            CHECK(name.empty());
+        }
+
+        TEST(Version, 3, VersionBase)
+        {
+            ProcessArgs({ "--bad", "--version" }, false, "");
+        }
+
+        TEST(Version, 4, VersionBase)
+        {
+            ProcessArgs({ "-ab", "-a2", "--version" }, false, "");
+            CHECK_EQUAL(0, a);
+        }
+
+        TEST(Version, 5, VersionBase)
+        {
+            ProcessArgs({ "--name", "--version" }, false, "");
+        }
+
+        TEST(Version, 6, VersionBase)
+        {
+            ProcessArgs({ "--bad", "--help" }, false, "Invalid argument: --bad");
+        }
+
+        TEST(Version, 7, VersionBase)
+        {
+            // A value that is version is still version
+            ProcessArgs({ "-a1", "--name", "--version" }, false, "");
+            CHECK_EQUAL(0, a);
+            CHECK(name.empty());
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    // linkage
+    namespace
+    {
+        TEST(Linkage, 1, Test)
+        {
+            // The library is also included by linkage.cpp, and gives the same results there
+            int num = 0;
+            std::string name;
+            HexBytes key;
+            std::string error;
+            CHECK(ProcessInSecondUnit({ "exe_pathname", "-n3", "--name=x", "--key=00ff" }, num, name, key, error));
+            CHECK_EQUAL(3, num);
+            CHECK_EQUAL("x", name);
+            CHECK_EQUAL(2u, key.size());
+            CHECK(!ProcessInSecondUnit({ "exe_pathname", "--key=0" }, num, name, key, error));
+            CHECK_EQUAL("Invalid argument: --key=0 (invalid hex)", error);
+        }
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////